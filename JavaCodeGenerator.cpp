@@ -244,13 +244,55 @@ std::string JavaCodeGenerator::generateBinaryExpr(const BinaryExpr* node, const
 }
 
 // --- Literal ---
+// Re-escape a decoded literal body for Java. Control bytes use octal escapes
+// because Java expands unicode escapes before lexing, so a newline written
+// that way would terminate the literal.
+static std::string escapeForJava(const std::string& decoded, char quote) {
+    std::string out;
+    out.reserve(decoded.size() + 8);
+    for (char c : decoded) {
+        unsigned char uc = static_cast<unsigned char>(c);
+        switch (c) {
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        case '\r': out += "\\r"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        case '\\': out += "\\\\"; break;
+        default:
+            if (c == quote) {
+                out += '\\';
+                out += c;
+            }
+            else if (uc < 0x20 || uc == 0x7F) {
+                out += '\\';
+                out += static_cast<char>('0' + ((uc >> 6) & 7));
+                out += static_cast<char>('0' + ((uc >> 3) & 7));
+                out += static_cast<char>('0' + (uc & 7));
+            }
+            else {
+                out += c;
+            }
+            break;
+        }
+    }
+    return out;
+}
+
 std::string JavaCodeGenerator::generateLiteral(const Literal* node) const {
+    if (node->kind == "string" || node->kind == "char") {
+        char quote = node->kind == "string" ? '"' : '\'';
+        // Escape-free literals are valid Java verbatim; only decode when needed
+        std::string body = node->hasEscape ? escapeForJava(decodeEscapes(node->value), quote)
+                                           : node->value;
+        return quote + body + quote;
+    }
     return node->value;
 }
 
 // --- Identifier ---
 std::string JavaCodeGenerator::generateIdentifier(const Identifier* node) const {
-    return node->name;
+    return node->name.str();
 }
 
 // --- Type Mapping: ASTNode* to Java type string ---
@@ -462,7 +504,7 @@ std::string JavaCodeGenerator::generateArrayAccess(const ArrayAccess* node, cons
     // Try to get the type from the symbol table if arrayExpr is an Identifier
     const ASTNode* typeNode = nullptr;
     if (node->arrayExpr->type == ASTNodeType::IDENTIFIER) {
-        std::string varName = static_cast<const Identifier*>(node->arrayExpr.get())->name;
+        Symbol varName = static_cast<const Identifier*>(node->arrayExpr.get())->name;
         auto it = symbolTable.find(varName);
         if (it != symbolTable.end()) {
             typeNode = it->second;
@@ -8,7 +8,7 @@
 class JavaCodeGenerator {
 public:
     std::string generate(const ASTNode* node, const std::string& className = "Main") const;
-    mutable std::unordered_map<std::string, const ASTNode*> symbolTable;
+    mutable std::unordered_map<Symbol, const ASTNode*> symbolTable;   // Variable -> declared type
     mutable std::set<std::string> requiredImports;
     std::set<std::string> userDefinedTemplates;
 
@@ -1,33 +1,106 @@
 #include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\lexer.hpp"
 #include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\lexer_tester.hpp"  // Include lexer tester header
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\source_buffer.hpp"
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\token_cache.hpp"
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\include_resolver.hpp"
+#include <memory>
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <string>
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
-        std::cout << "Usage: " << argv[0] << " <source_file>\n";
+        std::cout << "Usage: " << argv[0]
+                  << " <source_file> [--parse] [--bench] [--token-memory] [--parallel] [--ndjson] [--stats]"
+                  << " [--token-cache <dir>] [-I <dir>]...\n"
+                  << "       " << argv[0] << " --preprocessor-tests\n"
+                  << "       " << argv[0] << " --parser-tests\n"
+                  << "       " << argv[0] << " --lexer-tests\n";
         return 1;
     }
+    if (std::string(argv[1]) == "--preprocessor-tests") {
+        return runPreprocessorTests() == 0 ? 0 : 1;
+    }
+    if (std::string(argv[1]) == "--parser-tests") {
+        return runParserTests() == 0 ? 0 : 1;
+    }
+    if (std::string(argv[1]) == "--lexer-tests") {
+        return runLexerTests() == 0 ? 0 : 1;
+    }
+
+    bool parse = false;
+    bool bench = false;
+    bool tokenMemory = false;
+    LexerTestOptions options;
+    std::unique_ptr<TokenCache> cache;
+    IncludeResolver includes;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--parse") {
+            parse = true;
+        }
+        else if (arg == "--bench") {
+            bench = true;
+        }
+        else if (arg == "--token-memory") {
+            tokenMemory = true;
+        }
+        else if (arg == "--parallel") {
+            options.parallel = true;
+        }
+        else if (arg == "--ndjson") {
+            options.format = DumpFormat::Ndjson;
+        }
+        else if (arg == "--stats") {
+            options.stats = true;
+        }
+        else if (arg == "--token-cache" && i + 1 < argc) {
+            cache = std::make_unique<TokenCache>(argv[++i]);
+        }
+        else if (arg == "-I" && i + 1 < argc) {
+            includes.addSearchPath(argv[++i]);
+        }
+        else {
+            std::cerr << "Error: Unknown option '" << arg << "'\n";
+            return 1;
+        }
+    }
 
-    std::ifstream file(argv[1]);
-    if (!file.is_open()) {
+    // Memory-mapped (or single-read) view of the file; no intermediate copies
+    SourceBuffer source;
+    if (!source.open(argv[1])) {
         std::cerr << "Error: Could not open source file '" << argv[1] << "'\n";
         return 1;
     }
 
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string source = buffer.str();
-    file.close();
+    if (bench) {
+        benchCharClass(source.view());
+        return 0;
+    }
+    if (tokenMemory) {
+        reportTokenMemory(source.view(), &includes, argv[1]);
+        return 0;
+    }
+    if (parse) {
+        options.includes = &includes;
+        options.path = argv[1];
+        return testParser(source.view(), options) == 0 ? 0 : 1;
+    }
 
-    std::cout << "Running lexer tester on source file: " << argv[1] << "\n\n";
+    // NDJSON output is consumed by tools, so it gets no banner lines
+    bool banner = options.format == DumpFormat::Text;
+    if (banner) {
+        std::cout << "Running lexer tester on source file: " << argv[1] << "\n\n";
+    }
 
     // Call lexer tester function that prints tokens or errors
-    testLexer(source);
+    options.cache = cache.get();
+    options.includes = &includes;
+    options.path = argv[1];
+    testLexer(source.view(), options);
 
-    std::cout << "\nLexer test completed.\n";
+    if (banner) {
+        std::cout << "\nLexer test completed.\n";
+    }
 
     return 0;
 }
@@ -0,0 +1,52 @@
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\arena.hpp"
+
+void* Arena::allocateSlow(size_t size, size_t align) {
+    size_t needed = size + align - 1;
+    if (needed > chunkSize_ / 4) {
+        // Large request: a chunk of its own, so the current chunk keeps its free space
+        chunks_.push_back(Chunk{std::make_unique<char[]>(needed), needed});
+        reserved_ += needed;
+        used_ += size;
+        uintptr_t base = reinterpret_cast<uintptr_t>(chunks_.back().memory.get());
+        return reinterpret_cast<void*>((base + align - 1) / align * align);
+    }
+
+    chunks_.push_back(Chunk{std::make_unique<char[]>(chunkSize_), chunkSize_});
+    reserved_ += chunkSize_;
+    cursor_ = chunks_.back().memory.get();
+    limit_ = cursor_ + chunkSize_;
+    return allocate(size, align);
+}
+
+void Arena::reset() {
+    size_t keep = 0;
+    while (keep < chunks_.size() && chunks_[keep].size != chunkSize_) keep++;
+    if (keep < chunks_.size()) {
+        Chunk first = std::move(chunks_[keep]);
+        chunks_.clear();
+        chunks_.push_back(std::move(first));
+        cursor_ = chunks_.back().memory.get();
+        limit_ = cursor_ + chunkSize_;
+        reserved_ = chunkSize_;
+    } else {
+        chunks_.clear();
+        cursor_ = limit_ = nullptr;
+        reserved_ = 0;
+    }
+    used_ = 0;
+}
+
+void Arena::adopt(Arena& other) {
+    if (&other == this) return;
+    chunks_.reserve(chunks_.size() + other.chunks_.size());
+    for (Chunk& chunk : other.chunks_) {
+        chunks_.push_back(std::move(chunk));   // The memory itself stays put
+    }
+    reserved_ += other.reserved_;
+    used_ += other.used_;
+
+    other.chunks_.clear();
+    other.cursor_ = other.limit_ = nullptr;
+    other.reserved_ = 0;
+    other.used_ = 0;
+}
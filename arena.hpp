@@ -0,0 +1,100 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Chunked bump allocator.
+//
+// Allocations are carved out of large chunks by advancing a pointer, so a
+// whole translation unit's worth of small objects costs one malloc per
+// chunk. Nothing is freed individually: memory goes all at once on reset()
+// or destruction. Chunks never move, so pointers and views stay valid until
+// then. Only trivially destructible objects may be placed here, since no
+// destructor is ever run. Not thread-safe.
+class Arena {
+public:
+    static constexpr size_t kDefaultChunkSize = 64 * 1024;
+
+    explicit Arena(size_t chunkSize = kDefaultChunkSize) : chunkSize_(chunkSize) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        size_t pad = (align - reinterpret_cast<uintptr_t>(cursor_) % align) % align;
+        if (size + pad > static_cast<size_t>(limit_ - cursor_)) {
+            return allocateSlow(size, align);
+        }
+        void* result = cursor_ + pad;
+        cursor_ += pad + size;
+        used_ += size;
+        return result;
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena never runs destructors");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Copy text into the arena; the view lives as long as the arena's memory
+    std::string_view copy(std::string_view text) {
+        if (text.empty()) return {};
+        char* out = static_cast<char*>(allocate(text.size(), 1));
+        std::memcpy(out, text.data(), text.size());
+        return std::string_view(out, text.size());
+    }
+
+    // Concatenate pieces straight into the arena (no temporary std::string)
+    std::string_view concat(std::initializer_list<std::string_view> parts) {
+        size_t total = 0;
+        for (std::string_view part : parts) total += part.size();
+        if (total == 0) return {};
+        char* out = static_cast<char*>(allocate(total, 1));
+        char* p = out;
+        for (std::string_view part : parts) {
+            if (part.empty()) continue;   // data() may be null, which memcpy must not see
+            std::memcpy(p, part.data(), part.size());
+            p += part.size();
+        }
+        return std::string_view(out, total);
+    }
+
+    // Release everything. The first regular chunk is kept for reuse.
+    void reset();
+
+    // Take over other's chunks, so everything allocated there now lives as
+    // long as this arena; other is left empty. Allocation carries on in this
+    // arena's current chunk.
+    void adopt(Arena& other);
+
+    // --- Statistics ---
+    size_t chunkCount() const { return chunks_.size(); }       // Chunks held, one malloc each
+    size_t bytesReserved() const { return reserved_; }         // Total chunk capacity
+    size_t bytesUsed() const { return used_; }                 // Handed out, excluding alignment padding
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> memory;
+        size_t size;
+    };
+
+    std::vector<Chunk> chunks_;
+    char* cursor_ = nullptr;     // Free space in the current chunk
+    char* limit_ = nullptr;
+    size_t chunkSize_;
+    size_t reserved_ = 0;
+    size_t used_ = 0;
+
+    void* allocateSlow(size_t size, size_t align);
+};
+
+#endif // ARENA_HPP
@@ -6,6 +6,7 @@
 #include <memory>
 // #include <optional>
 #include "tokens.hpp"  // your existing token types for reference if needed
+#include "ast_arena.hpp"
 
 // Enumerate all node types in AST
 enum class ASTNodeType {
@@ -275,7 +276,7 @@ public:
 // Program node: root container for all global declarations
 class Program : public ASTNode {
 public:
-    std::vector<std::unique_ptr<ASTNode>> globals;
+    std::vector<ArenaPtr<ASTNode>> globals;
 
     Program() : ASTNode(ASTNodeType::PROGRAM) {}
 };
@@ -295,7 +296,7 @@ public:
 class NamespaceDecl : public ASTNode {
 public:
     std::string name;
-    std::vector<std::unique_ptr<ASTNode>> declarations;
+    std::vector<ArenaPtr<ASTNode>> declarations;
 
     explicit NamespaceDecl(std::string nsName)
         : ASTNode(ASTNodeType::NAMESPACE_DECL), name(std::move(nsName)) {}
@@ -316,7 +317,7 @@ public:
 class ClassDecl : public ASTNode {
 public:
     std::string name;
-    std::vector<std::unique_ptr<ASTNode>> members;  // variables, functions, nested classes, etc.
+    std::vector<ArenaPtr<ASTNode>> members;  // variables, functions, nested classes, etc.
 
     explicit ClassDecl(std::string className)
         : ASTNode(ASTNodeType::CLASS_DECL), name(std::move(className)) {}
@@ -327,7 +328,7 @@ public:
 class StructDecl : public ASTNode {
 public:
     std::string name;
-    std::vector<std::unique_ptr<ASTNode>> members;
+    std::vector<ArenaPtr<ASTNode>> members;
 
     explicit StructDecl(std::string structName)
         : ASTNode(ASTNodeType::STRUCT_DECL), name(std::move(structName)) {}
@@ -353,68 +354,64 @@ public:
 class UnionDecl : public ASTNode {
 public:
     std::string name;
-    std::vector<std::unique_ptr<ASTNode>> members;
+    std::vector<ArenaPtr<ASTNode>> members;
 
     explicit UnionDecl(std::string unionName)
         : ASTNode(ASTNodeType::UNION_DECL), name(std::move(unionName)) {}
+
+    UnionDecl(std::string unionName, std::vector<ArenaPtr<ASTNode>> memberList)
+        : ASTNode(ASTNodeType::UNION_DECL), name(std::move(unionName)), members(std::move(memberList)) {}
 };
 
 
 // Function declaration
 class FunctionDecl : public ASTNode {
 public:
-    std::string name;
-    std::unique_ptr<ASTNode> returnType; // type node
-    std::vector<std::unique_ptr<ASTNode>> parameters; // VarDecl or similar
-    std::unique_ptr<ASTNode> body; // BlockStmt or expression (for lambdas)
+    Symbol name;
+    ArenaPtr<ASTNode> returnType; // type node
+    std::vector<ArenaPtr<ASTNode>> parameters; // VarDecl or similar
+    ArenaPtr<ASTNode> body; // BlockStmt or expression (for lambdas)
     bool isConst = false;
     bool isVirtual = false;
     bool isStatic = false;
     bool isConstructor = false;
     bool isDestructor = false;
 
-    explicit FunctionDecl(std::string funcName)
-        : ASTNode(ASTNodeType::FUNCTION_DECL), name(std::move(funcName)) {}
+    explicit FunctionDecl(Symbol funcName)
+        : ASTNode(ASTNodeType::FUNCTION_DECL), name(funcName) {}
 };
 
 
 // Variable declaration
 class VarDecl : public ASTNode {
 public:
-    std::string name;
-    std::unique_ptr<ASTNode> type;  // type node
-    std::unique_ptr<ASTNode> initializer; // optional initializer expression
+    Symbol name;
+    ArenaPtr<ASTNode> type;  // type node
+    ArenaPtr<ASTNode> initializer; // optional initializer expression
     bool isStatic = false;
     bool isConst = false;
 
-    VarDecl(std::string varName,
-            std::unique_ptr<ASTNode> typeNode = nullptr,
-            std::unique_ptr<ASTNode> init = nullptr,
+    VarDecl(Symbol varName,
+            ArenaPtr<ASTNode> typeNode = nullptr,
+            ArenaPtr<ASTNode> init = nullptr,
             bool isStatic_ = false,
             bool isConst_ = false)
         : ASTNode(ASTNodeType::VAR_DECL),
-          name(std::move(varName)),
+          name(varName),
           type(std::move(typeNode)),
           initializer(std::move(init)),
           isStatic(isStatic_),
           isConst(isConst_) {}
 };
 
-class InitializerListExpr : public Expression {
-public:
-    std::vector<std::unique_ptr<ASTNode>> elements;
-    InitializerListExpr(std::vector<std::unique_ptr<ASTNode>> elems)
-        : Expression(ASTNodeType::INITIALIZER_LIST_EXPR), elements(std::move(elems)) {}
-};
-
 // Typedef or using alias
 
 class TypedefDecl : public ASTNode {
 public:
     std::string aliasName;
-    std::unique_ptr<ASTNode> aliasedType;
+    ArenaPtr<ASTNode> aliasedType;
 
-    TypedefDecl(std::string alias, std::unique_ptr<ASTNode> aliased)
+    TypedefDecl(std::string alias, ArenaPtr<ASTNode> aliased)
         : ASTNode(ASTNodeType::TYPEDEF_DECL), aliasName(std::move(alias)), aliasedType(std::move(aliased)) {}
 };
 
@@ -429,7 +426,7 @@ public:
 // Block statement: a sequence of statements
 class BlockStmt : public Statement {
 public:
-    std::vector<std::unique_ptr<ASTNode>> statements;
+    std::vector<ArenaPtr<ASTNode>> statements;
 
     BlockStmt() : Statement(ASTNodeType::BLOCK_STMT) {}
 };
@@ -438,9 +435,9 @@ public:
 // Expression statement: a statement that is just an expression (e.g., function call)
 class ExpressionStmt : public Statement {
 public:
-    std::unique_ptr<ASTNode> expression;
+    ArenaPtr<ASTNode> expression;
 
-    explicit ExpressionStmt(std::unique_ptr<ASTNode> expr)
+    explicit ExpressionStmt(ArenaPtr<ASTNode> expr)
         : Statement(ASTNodeType::EXPRESSION_STMT), expression(std::move(expr)) {}
 };
 
@@ -448,21 +445,25 @@ public:
 // If statement
 class IfStmt : public Statement {
 public:
-    std::unique_ptr<ASTNode> condition;
-    std::unique_ptr<ASTNode> thenBranch;
-    std::unique_ptr<ASTNode> elseBranch; // can be nullptr or ElseStmt or another IfStmt
+    ArenaPtr<ASTNode> condition;
+    ArenaPtr<ASTNode> thenBranch;
+    ArenaPtr<ASTNode> elseBranch; // can be nullptr or ElseStmt or another IfStmt
 
     IfStmt()
         : Statement(ASTNodeType::IF_STMT) {}
+
+    IfStmt(ArenaPtr<ASTNode> cond, ArenaPtr<ASTNode> thenBr, ArenaPtr<ASTNode> elseBr)
+        : Statement(ASTNodeType::IF_STMT), condition(std::move(cond)),
+          thenBranch(std::move(thenBr)), elseBranch(std::move(elseBr)) {}
 };
 
 
 // Else statement (optional explicit node)
 class ElseStmt : public Statement {
 public:
-    std::unique_ptr<ASTNode> elseBranch;
+    ArenaPtr<ASTNode> elseBranch;
 
-    explicit ElseStmt(std::unique_ptr<ASTNode> elseBr)
+    explicit ElseStmt(ArenaPtr<ASTNode> elseBr)
         : Statement(ASTNodeType::ELSE_STMT), elseBranch(std::move(elseBr)) {}
 };
 
@@ -470,45 +471,58 @@ public:
 // While statement
 class WhileStmt : public Statement {
 public:
-    std::unique_ptr<ASTNode> condition;
-    std::unique_ptr<ASTNode> body;
+    ArenaPtr<ASTNode> condition;
+    ArenaPtr<ASTNode> body;
 
     WhileStmt()
         : Statement(ASTNodeType::WHILE_STMT) {}
+
+    WhileStmt(ArenaPtr<ASTNode> cond, ArenaPtr<ASTNode> bodyStmt)
+        : Statement(ASTNodeType::WHILE_STMT), condition(std::move(cond)), body(std::move(bodyStmt)) {}
 };
 
 
 // Do-While statement
 class DoWhileStmt : public Statement {
 public:
-    std::unique_ptr<ASTNode> body;
-    std::unique_ptr<ASTNode> condition;
+    ArenaPtr<ASTNode> body;
+    ArenaPtr<ASTNode> condition;
 
     DoWhileStmt()
         : Statement(ASTNodeType::DO_WHILE_STMT) {}
+
+    DoWhileStmt(ArenaPtr<ASTNode> cond, ArenaPtr<ASTNode> bodyStmt)
+        : Statement(ASTNodeType::DO_WHILE_STMT), body(std::move(bodyStmt)), condition(std::move(cond)) {}
 };
 
 
 // For statement
 class ForStmt : public Statement {
 public:
-    std::unique_ptr<ASTNode> init;       // e.g. VarDecl or ExpressionStmt, can be nullptr
-    std::unique_ptr<ASTNode> condition;  // can be nullptr
-    std::unique_ptr<ASTNode> increment;  // can be nullptr
-    std::unique_ptr<ASTNode> body;
+    ArenaPtr<ASTNode> init;       // e.g. VarDecl or ExpressionStmt, can be nullptr
+    ArenaPtr<ASTNode> condition;  // can be nullptr
+    ArenaPtr<ASTNode> increment;  // can be nullptr
+    ArenaPtr<ASTNode> body;
 
     ForStmt()
         : Statement(ASTNodeType::FOR_STMT) {}
+
+    ForStmt(ArenaPtr<ASTNode> initStmt, ArenaPtr<ASTNode> cond, ArenaPtr<ASTNode> inc, ArenaPtr<ASTNode> bodyStmt)
+        : Statement(ASTNodeType::FOR_STMT), init(std::move(initStmt)), condition(std::move(cond)),
+          increment(std::move(inc)), body(std::move(bodyStmt)) {}
 };
 
 
 // Return statement
 class ReturnStmt : public Statement {
 public:
-    std::unique_ptr<ASTNode> expression; // optional
+    ArenaPtr<ASTNode> expression; // optional
 
     ReturnStmt()
         : Statement(ASTNodeType::RETURN_STMT) {}
+
+    explicit ReturnStmt(ArenaPtr<ASTNode> expr)
+        : Statement(ASTNodeType::RETURN_STMT), expression(std::move(expr)) {}
 };
 
 
@@ -541,61 +555,71 @@ public:
 // Try statement
 class TryStmt : public Statement {
 public:
-    std::unique_ptr<BlockStmt> tryBlock;
-    std::vector<std::unique_ptr<ASTNode>> catchClauses;  // Catches
+    ArenaPtr<ASTNode> tryBlock;                    // BlockStmt
+    std::vector<ArenaPtr<ASTNode>> catchClauses;  // Catches
 
     TryStmt()
         : Statement(ASTNodeType::TRY_STMT) {}
+
+    TryStmt(ArenaPtr<ASTNode> block, std::vector<ArenaPtr<ASTNode>> catches)
+        : Statement(ASTNodeType::TRY_STMT), tryBlock(std::move(block)), catchClauses(std::move(catches)) {}
 };
 
 
 // Catch statement
 class CatchStmt : public Statement {
 public:
-    std::unique_ptr<ASTNode> exceptionType; // type of exception caught, e.g. std::exception
+    ArenaPtr<ASTNode> exceptionType; // type of exception caught, e.g. std::exception
     std::string exceptionVar;                // catch (const std::exception& e)
-    std::unique_ptr<BlockStmt> body;
+    ArenaPtr<ASTNode> body;                  // BlockStmt
 
     CatchStmt()
         : Statement(ASTNodeType::CATCH_STMT) {}
+
+    CatchStmt(ArenaPtr<ASTNode> type, std::string var, ArenaPtr<ASTNode> block)
+        : Statement(ASTNodeType::CATCH_STMT), exceptionType(std::move(type)),
+          exceptionVar(std::move(var)), body(std::move(block)) {}
 };
 
 
 // Throw statement
 class ThrowStmt : public Statement {
 public:
-    std::unique_ptr<ASTNode> expression;
+    ArenaPtr<ASTNode> expression;
 
     ThrowStmt()
         : Statement(ASTNodeType::THROW_STMT) {}
+
+    explicit ThrowStmt(ArenaPtr<ASTNode> expr)
+        : Statement(ASTNodeType::THROW_STMT), expression(std::move(expr)) {}
 };
 
 // Switch statement
 class SwitchStmt : public Statement {
 public:
-    std::unique_ptr<ASTNode> condition;
-    std::vector<std::unique_ptr<ASTNode>> cases; // CaseStmt and DefaultStmt
+    ArenaPtr<ASTNode> condition;
+    std::vector<ArenaPtr<ASTNode>> cases; // CaseStmt and DefaultStmt
 
-    SwitchStmt(std::unique_ptr<ASTNode> cond, std::vector<std::unique_ptr<ASTNode>> caseList)
+    SwitchStmt(ArenaPtr<ASTNode> cond, std::vector<ArenaPtr<ASTNode>> caseList)
         : Statement(ASTNodeType::SWITCH_STMT), condition(std::move(cond)), cases(std::move(caseList)) {}
 };
 
 // Case statement
 class CaseStmt : public Statement {
 public:
-    std::unique_ptr<ASTNode> value; // case value expression
-    std::vector<std::unique_ptr<ASTNode>> statements;
+    ArenaPtr<ASTNode> value; // case value expression
+    std::vector<ArenaPtr<ASTNode>> statements;
 
-    CaseStmt(std::unique_ptr<ASTNode> val, std::vector<std::unique_ptr<ASTNode>> stmts)
+    CaseStmt(ArenaPtr<ASTNode> val, std::vector<ArenaPtr<ASTNode>> stmts)
         : Statement(ASTNodeType::CASE_STMT), value(std::move(val)), statements(std::move(stmts)) {}
 };
 
 // Default statement
 class DefaultStmt : public Statement {
 public:
-    std::vector<std::unique_ptr<ASTNode>> statements;
+    std::vector<ArenaPtr<ASTNode>> statements;
 
-    explicit DefaultStmt(std::vector<std::unique_ptr<ASTNode>> stmts)
+    explicit DefaultStmt(std::vector<ArenaPtr<ASTNode>> stmts)
         : Statement(ASTNodeType::DEFAULT_STMT), statements(std::move(stmts)) {}
 };
 
@@ -607,23 +631,38 @@ public:
 };
 
 
+// Braced initializer list: {a, b, c}
+class InitializerListExpr : public Expression {
+public:
+    std::vector<ArenaPtr<ASTNode>> elements;
+    InitializerListExpr(std::vector<ArenaPtr<ASTNode>> elems)
+        : Expression(ASTNodeType::INITIALIZER_LIST_EXPR), elements(std::move(elems)) {}
+};
+
+
 // Literal expression
 class Literal : public Expression {
 public:
     std::string value; // raw literal text or parsed value
+    std::string kind;  // "int", "float", "string", "char" (empty if unknown)
+    bool hasEscape = false; // value still contains undecoded escape sequences
 
     explicit Literal(std::string val)
         : Expression(ASTNodeType::LITERAL), value(std::move(val)) {}
+
+    Literal(std::string val, std::string litKind, bool escaped = false)
+        : Expression(ASTNodeType::LITERAL), value(std::move(val)),
+          kind(std::move(litKind)), hasEscape(escaped) {}
 };
 
 
 // Identifier expression
 class Identifier : public Expression {
 public:
-    std::string name;
+    Symbol name;   // Interned; compare and hash by ID
 
-    explicit Identifier(std::string idName)
-        : Expression(ASTNodeType::IDENTIFIER), name(std::move(idName)) {}
+    explicit Identifier(Symbol idName)
+        : Expression(ASTNodeType::IDENTIFIER), name(idName) {}
 };
 
 
@@ -631,10 +670,10 @@ public:
 class BinaryExpr : public Expression {
 public:
     std::string op;  // operator string, e.g. "+", "==", etc.
-    std::unique_ptr<ASTNode> left;
-    std::unique_ptr<ASTNode> right;
+    ArenaPtr<ASTNode> left;
+    ArenaPtr<ASTNode> right;
 
-    BinaryExpr(std::string oper, std::unique_ptr<ASTNode> lhs, std::unique_ptr<ASTNode> rhs)
+    BinaryExpr(std::string oper, ArenaPtr<ASTNode> lhs, ArenaPtr<ASTNode> rhs)
         : Expression(ASTNodeType::BINARY_EXPR), op(std::move(oper)),
           left(std::move(lhs)), right(std::move(rhs)) {}
 };
@@ -644,10 +683,10 @@ public:
 class UnaryExpr : public Expression {
 public:
     std::string op;  // e.g. "-", "!", "&", "*"
-    std::unique_ptr<ASTNode> operand;
+    ArenaPtr<ASTNode> operand;
     bool isPrefix;
 
-    UnaryExpr(std::string oper, std::unique_ptr<ASTNode> opd, bool prefix)
+    UnaryExpr(std::string oper, ArenaPtr<ASTNode> opd, bool prefix)
         : Expression(ASTNodeType::UNARY_EXPR), op(std::move(oper)),
           operand(std::move(opd)), isPrefix(prefix) {}
 };
@@ -656,11 +695,11 @@ public:
 // Ternary expression
 class TernaryExpr : public Expression {
 public:
-    std::unique_ptr<ASTNode> condition;
-    std::unique_ptr<ASTNode> trueExpr;
-    std::unique_ptr<ASTNode> falseExpr;
+    ArenaPtr<ASTNode> condition;
+    ArenaPtr<ASTNode> trueExpr;
+    ArenaPtr<ASTNode> falseExpr;
 
-    TernaryExpr(std::unique_ptr<ASTNode> cond, std::unique_ptr<ASTNode> t, std::unique_ptr<ASTNode> f)
+    TernaryExpr(ArenaPtr<ASTNode> cond, ArenaPtr<ASTNode> t, ArenaPtr<ASTNode> f)
         : Expression(ASTNodeType::TERNARY_EXPR),
           condition(std::move(cond)), trueExpr(std::move(t)), falseExpr(std::move(f)) {}
 };
@@ -669,11 +708,14 @@ public:
 // Function call expression
 class FunctionCall : public Expression {
 public:
-    std::unique_ptr<ASTNode> callee; // function identifier or expression
-    std::vector<std::unique_ptr<ASTNode>> arguments;
+    ArenaPtr<ASTNode> callee; // function identifier or expression
+    std::vector<ArenaPtr<ASTNode>> arguments;
 
-    explicit FunctionCall(std::unique_ptr<ASTNode> calleeNode)
+    explicit FunctionCall(ArenaPtr<ASTNode> calleeNode)
         : Expression(ASTNodeType::FUNCTION_CALL), callee(std::move(calleeNode)) {}
+
+    FunctionCall(ArenaPtr<ASTNode> calleeNode, std::vector<ArenaPtr<ASTNode>> args)
+        : Expression(ASTNodeType::FUNCTION_CALL), callee(std::move(calleeNode)), arguments(std::move(args)) {}
 };
 
 
@@ -685,11 +727,11 @@ public:
 // Member access expression: obj.member or obj->member
 class MemberAccess : public Expression {
 public:
-    std::unique_ptr<ASTNode> object;
+    ArenaPtr<ASTNode> object;
     std::string memberName;
     bool isArrow;  // true for '->', false for '.'
 
-    MemberAccess(std::unique_ptr<ASTNode> obj, std::string member, bool arrow)
+    MemberAccess(ArenaPtr<ASTNode> obj, std::string member, bool arrow)
         : Expression(ASTNodeType::MEMBER_ACCESS),
           object(std::move(obj)), memberName(std::move(member)), isArrow(arrow) {}
 };
@@ -698,19 +740,19 @@ public:
 // Array access: arr[i]
 class ArrayAccess : public Expression {
 public:
-    std::unique_ptr<ASTNode> arrayExpr;
-    std::unique_ptr<ASTNode> indexExpr;
+    ArenaPtr<ASTNode> arrayExpr;
+    ArenaPtr<ASTNode> indexExpr;
 
-    ArrayAccess(std::unique_ptr<ASTNode> arr, std::unique_ptr<ASTNode> idx)
+    ArrayAccess(ArenaPtr<ASTNode> arr, ArenaPtr<ASTNode> idx)
         : Expression(ASTNodeType::ARRAY_ACCESS),
           arrayExpr(std::move(arr)), indexExpr(std::move(idx)) {}
 };
 
 class ArrayType : public ASTNode {
 public:
-    std::unique_ptr<ASTNode> elementType;
+    ArenaPtr<ASTNode> elementType;
     int size;
-    ArrayType(std::unique_ptr<ASTNode> elem, int sz)
+    ArrayType(ArenaPtr<ASTNode> elem, int sz)
         : ASTNode(ASTNodeType::ARRAY_TYPE), elementType(std::move(elem)), size(sz) {}
 };
 
@@ -718,11 +760,11 @@ public:
 // STL vector access or push_back etc.
 class VectorAccess : public Expression {
 public:
-    std::unique_ptr<ASTNode> vectorExpr;
+    ArenaPtr<ASTNode> vectorExpr;
     std::string method; // e.g., "push_back", "size", "at"
-    std::vector<std::unique_ptr<ASTNode>> arguments;
+    std::vector<ArenaPtr<ASTNode>> arguments;
 
-    VectorAccess(std::unique_ptr<ASTNode> vec, std::string m)
+    VectorAccess(ArenaPtr<ASTNode> vec, std::string m)
         : Expression(ASTNodeType::FUNCTION_CALL), vectorExpr(std::move(vec)), method(std::move(m)) {}
 };
 
@@ -730,9 +772,13 @@ public:
 // std::cout, std::cin stream expression
 class StreamExpr : public Expression {
 public:
-    std::vector<std::unique_ptr<ASTNode>> chain;  // e.g. cout << x << y;
+    std::string op;                        // "<<" or ">>"
+    std::vector<ArenaPtr<ASTNode>> chain;  // e.g. cout << x << y: [cout, x, y]
 
     StreamExpr() : Expression(ASTNodeType::STREAM_EXPR) {}
+
+    StreamExpr(std::string oper, std::vector<ArenaPtr<ASTNode>> items)
+        : Expression(ASTNodeType::STREAM_EXPR), op(std::move(oper)), chain(std::move(items)) {}
 };
 
 
@@ -741,58 +787,61 @@ public:
 class LambdaExpr : public Expression {
 public:
     std::vector<std::string> captureList;
-    std::vector<std::unique_ptr<ASTNode>> parameters; // like VarDecl
-    std::unique_ptr<ASTNode> returnType;
-    std::unique_ptr<ASTNode> body; // usually BlockStmt
+    std::vector<ArenaPtr<ASTNode>> parameters; // like VarDecl
+    ArenaPtr<ASTNode> returnType;
+    ArenaPtr<ASTNode> body; // usually BlockStmt
 
     LambdaExpr(std::vector<std::string> captures,
-               std::vector<std::unique_ptr<ASTNode>> params,
-               std::unique_ptr<ASTNode> retType,
-               std::unique_ptr<ASTNode> bodyExpr)
+               std::vector<ArenaPtr<ASTNode>> params,
+               ArenaPtr<ASTNode> retType,
+               ArenaPtr<ASTNode> bodyExpr)
         : Expression(ASTNodeType::LAMBDA_EXPR),
           captureList(std::move(captures)),
           parameters(std::move(params)),
           returnType(std::move(retType)),
           body(std::move(bodyExpr)) {}
+
+    LambdaExpr(std::vector<ArenaPtr<ASTNode>> params, ArenaPtr<ASTNode> bodyExpr)
+        : LambdaExpr({}, std::move(params), nullptr, std::move(bodyExpr)) {}
 };
 
 // Casts
 class StaticCastExpr : public Expression {
 public:
-    std::unique_ptr<ASTNode> targetType;
-    std::unique_ptr<ASTNode> expr;
+    ArenaPtr<ASTNode> targetType;
+    ArenaPtr<ASTNode> expr;
 
-    StaticCastExpr(std::unique_ptr<ASTNode> type, std::unique_ptr<ASTNode> e)
+    StaticCastExpr(ArenaPtr<ASTNode> type, ArenaPtr<ASTNode> e)
         : Expression(ASTNodeType::STATIC_CAST_EXPR), targetType(std::move(type)), expr(std::move(e)) {}
 };
 
 
 class DynamicCastExpr : public Expression {
 public:
-    std::unique_ptr<ASTNode> targetType;
-    std::unique_ptr<ASTNode> expr;
+    ArenaPtr<ASTNode> targetType;
+    ArenaPtr<ASTNode> expr;
 
-    DynamicCastExpr(std::unique_ptr<ASTNode> type, std::unique_ptr<ASTNode> e)
+    DynamicCastExpr(ArenaPtr<ASTNode> type, ArenaPtr<ASTNode> e)
         : Expression(ASTNodeType::DYNAMIC_CAST_EXPR), targetType(std::move(type)), expr(std::move(e)) {}
 };
 
 
 class ConstCastExpr : public Expression {
 public:
-    std::unique_ptr<ASTNode> targetType;
-    std::unique_ptr<ASTNode> expr;
+    ArenaPtr<ASTNode> targetType;
+    ArenaPtr<ASTNode> expr;
 
-    ConstCastExpr(std::unique_ptr<ASTNode> type, std::unique_ptr<ASTNode> e)
+    ConstCastExpr(ArenaPtr<ASTNode> type, ArenaPtr<ASTNode> e)
         : Expression(ASTNodeType::CONST_CAST_EXPR), targetType(std::move(type)), expr(std::move(e)) {}
 };
 
 
 class ReinterpretCastExpr : public Expression {
 public:
-    std::unique_ptr<ASTNode> targetType;
-    std::unique_ptr<ASTNode> expr;
+    ArenaPtr<ASTNode> targetType;
+    ArenaPtr<ASTNode> expr;
 
-    ReinterpretCastExpr(std::unique_ptr<ASTNode> type, std::unique_ptr<ASTNode> e)
+    ReinterpretCastExpr(ArenaPtr<ASTNode> type, ArenaPtr<ASTNode> e)
         : Expression(ASTNodeType::REINTERPRET_CAST_EXPR), targetType(std::move(type)), expr(std::move(e)) {}
 };
 
@@ -800,24 +849,34 @@ public:
 // typeid(expr)
 class TypeidExpr : public Expression {
 public:
-    std::unique_ptr<ASTNode> expr;
+    ArenaPtr<ASTNode> expr;
 
-    explicit TypeidExpr(std::unique_ptr<ASTNode> e)
+    explicit TypeidExpr(ArenaPtr<ASTNode> e)
         : Expression(ASTNodeType::TYPEID_EXPR), expr(std::move(e)) {}
 };
 
 
+// Template parameter (T, typename U, etc.)
+class TemplateParam : public ASTNode {
+public:
+    std::string name;
+
+    explicit TemplateParam(std::string paramName)
+        : ASTNode(ASTNodeType::TEMPLATE_PARAM), name(std::move(paramName)) {}
+};
+
+
 // Template type node (like vector<T>, map<K,V>)
 class TemplateClassDecl : public ASTNode {
 public:
     std::string name;
-    std::vector<std::unique_ptr<TemplateParam>> templateParams;
-    std::vector<std::unique_ptr<ASTNode>> members;
+    std::vector<ArenaPtr<TemplateParam>> templateParams;
+    std::vector<ArenaPtr<ASTNode>> members;
 
     TemplateClassDecl(
         const std::string& name,
-        std::vector<std::unique_ptr<TemplateParam>> params,
-        std::vector<std::unique_ptr<ASTNode>> members)
+        std::vector<ArenaPtr<TemplateParam>> params,
+        std::vector<ArenaPtr<ASTNode>> members)
         : ASTNode(ASTNodeType::TEMPLATE_CLASS_DECL),
           name(name),
           templateParams(std::move(params)),
@@ -828,46 +887,39 @@ public:
 class TemplateType : public ASTNode {
 public:
     std::string baseTypeName;  // e.g. "vector", "map"
-    std::vector<std::unique_ptr<ASTNode>> typeArgs;
+    std::vector<ArenaPtr<ASTNode>> typeArgs;
 
     explicit TemplateType(std::string base)
         : ASTNode(ASTNodeType::TEMPLATE_TYPE), baseTypeName(std::move(base)) {}
-};
 
-
-// Template parameter (T, typename U, etc.)
-class TemplateParam : public ASTNode {
-public:
-    std::string name;
-
-    explicit TemplateParam(std::string paramName)
-        : ASTNode(ASTNodeType::TEMPLATE_PARAM), name(std::move(paramName)) {}
+    TemplateType(std::string base, std::vector<ArenaPtr<ASTNode>> args)
+        : ASTNode(ASTNodeType::TEMPLATE_TYPE), baseTypeName(std::move(base)), typeArgs(std::move(args)) {}
 };
 
 
 // Template argument (type or expression)
 class TemplateArg : public ASTNode {
 public:
-    std::unique_ptr<ASTNode> arg;
+    ArenaPtr<ASTNode> arg;
 
-    explicit TemplateArg(std::unique_ptr<ASTNode> a)
+    explicit TemplateArg(ArenaPtr<ASTNode> a)
         : ASTNode(ASTNodeType::TEMPLATE_ARG), arg(std::move(a)) {}
 };
 
 class TemplateFunctionDecl : public ASTNode {
 public:
     std::string name;
-    std::vector<std::unique_ptr<TemplateParam>> templateParams;
-    std::unique_ptr<ASTNode> returnType;
-    std::vector<std::unique_ptr<VarDecl>> parameters;
-    std::unique_ptr<ASTNode> body;
+    std::vector<ArenaPtr<TemplateParam>> templateParams;
+    ArenaPtr<ASTNode> returnType;
+    std::vector<ArenaPtr<VarDecl>> parameters;
+    ArenaPtr<ASTNode> body;
 
     TemplateFunctionDecl(
         std::string n,
-        std::vector<std::unique_ptr<TemplateParam>> tparams,
-        std::unique_ptr<ASTNode> retType,
-        std::vector<std::unique_ptr<VarDecl>> params,
-        std::unique_ptr<ASTNode> b
+        std::vector<ArenaPtr<TemplateParam>> tparams,
+        ArenaPtr<ASTNode> retType,
+        std::vector<ArenaPtr<VarDecl>> params,
+        ArenaPtr<ASTNode> b
     )
         : ASTNode(ASTNodeType::TEMPLATE_FUNCTION_DECL),
           name(std::move(n)),
@@ -891,19 +943,19 @@ public:
 
 class QualifiedName : public ASTNode {
 public:
-    std::unique_ptr<ASTNode> left;
+    ArenaPtr<ASTNode> left;
     std::string right;
 
-    QualifiedName(std::unique_ptr<ASTNode> left, std::string right)
+    QualifiedName(ArenaPtr<ASTNode> left, std::string right)
         : ASTNode(ASTNodeType::QUALIFIED_TYPE), left(std::move(left)), right(std::move(right)) {}
 };
 
 // Pointer type
 class PointerType : public ASTNode {
 public:
-    std::unique_ptr<ASTNode> baseType;
+    ArenaPtr<ASTNode> baseType;
 
-    explicit PointerType(std::unique_ptr<ASTNode> base)
+    explicit PointerType(ArenaPtr<ASTNode> base)
         : ASTNode(ASTNodeType::POINTER_TYPE), baseType(std::move(base)) {}
 };
 
@@ -911,9 +963,9 @@ public:
 // Reference type
 class ReferenceType : public ASTNode {
 public:
-    std::unique_ptr<ASTNode> baseType;
+    ArenaPtr<ASTNode> baseType;
 
-    explicit ReferenceType(std::unique_ptr<ASTNode> base)
+    explicit ReferenceType(ArenaPtr<ASTNode> base)
         : ASTNode(ASTNodeType::REFERENCE_TYPE), baseType(std::move(base)) {}
 };
 
@@ -924,9 +976,9 @@ public:
 class ThreadDecl : public ASTNode {
 public:
     std::string threadVarName;
-    std::unique_ptr<ASTNode> callable;
+    ArenaPtr<ASTNode> callable;
 
-    ThreadDecl(std::string name, std::unique_ptr<ASTNode> call)
+    ThreadDecl(std::string name, ArenaPtr<ASTNode> call)
         : ASTNode(ASTNodeType::THREAD_DECL), threadVarName(std::move(name)), callable(std::move(call)) {}
 };
 
@@ -957,8 +1009,8 @@ public:
 // std::async
 class AsyncExpr : public Expression {
 public:
-    std::unique_ptr<ASTNode> callable;
-    std::vector<std::unique_ptr<ASTNode>> arguments;
+    ArenaPtr<ASTNode> callable;
+    std::vector<ArenaPtr<ASTNode>> arguments;
 
     AsyncExpr() : Expression(ASTNodeType::ASYNC_EXPR) {}
 };
@@ -986,7 +1038,7 @@ public:
 class MathFunctionCall : public Expression {
 public:
     std::string functionName; // e.g., "abs", "sqrt", "pow"
-    std::vector<std::unique_ptr<ASTNode>> arguments;
+    std::vector<ArenaPtr<ASTNode>> arguments;
 
     explicit MathFunctionCall(std::string name,ASTNodeType type)
         : Expression(type), functionName(std::move(name)) {}
@@ -1006,124 +1058,124 @@ public:
 // STL container example: std::vector<T> variable
 class VectorTypeExpr : public Expression {
 public:
-    std::vector<std::unique_ptr<ASTNode>> typeParams;
+    std::vector<ArenaPtr<ASTNode>> typeParams;
 
-    explicit VectorTypeExpr(std::vector<std::unique_ptr<ASTNode>> params)
+    explicit VectorTypeExpr(std::vector<ArenaPtr<ASTNode>> params)
         : Expression(ASTNodeType::VECTOR_TYPE), typeParams(std::move(params)) {}
 };
 
 // Algorithms
 class SortCall : public Expression {
 public:
-    std::unique_ptr<ASTNode> container;
+    ArenaPtr<ASTNode> container;
 
-    explicit SortCall(std::unique_ptr<ASTNode> cont)
+    explicit SortCall(ArenaPtr<ASTNode> cont)
         : Expression(ASTNodeType::SORT_CALL), container(std::move(cont)) {}
 };
 
 class AccumulateCall : public Expression {
 public:
-    std::unique_ptr<ASTNode> beginExpr;
-    std::unique_ptr<ASTNode> endExpr;
-    std::unique_ptr<ASTNode> initialValue;
+    ArenaPtr<ASTNode> beginExpr;
+    ArenaPtr<ASTNode> endExpr;
+    ArenaPtr<ASTNode> initialValue;
 
-    AccumulateCall(std::unique_ptr<ASTNode> b, std::unique_ptr<ASTNode> e, std::unique_ptr<ASTNode> init)
+    AccumulateCall(ArenaPtr<ASTNode> b, ArenaPtr<ASTNode> e, ArenaPtr<ASTNode> init)
         : Expression(ASTNodeType::ACCUMULATE_CALL), beginExpr(std::move(b)), endExpr(std::move(e)), initialValue(std::move(init)) {}
 };
 
 class FindCall : public Expression {
 public:
-    std::unique_ptr<ASTNode> container;
-    std::unique_ptr<ASTNode> value;
-    FindCall(std::unique_ptr<ASTNode> cont, std::unique_ptr<ASTNode> val)
+    ArenaPtr<ASTNode> container;
+    ArenaPtr<ASTNode> value;
+    FindCall(ArenaPtr<ASTNode> cont, ArenaPtr<ASTNode> val)
         : Expression(ASTNodeType::FIND_CALL), container(std::move(cont)), value(std::move(val)) {}
 };
 
 // I/O stream nodes
 class CoutExpr : public Expression {
 public:
-    std::vector<std::unique_ptr<ASTNode>> outputValues;
+    std::vector<ArenaPtr<ASTNode>> outputValues;
 
-    explicit CoutExpr(std::vector<std::unique_ptr<ASTNode>> values)
+    explicit CoutExpr(std::vector<ArenaPtr<ASTNode>> values)
         : Expression(ASTNodeType::COUT_EXPR), outputValues(std::move(values)) {}
 };
 
 class CinExpr : public Expression {
 public:
-    std::vector<std::unique_ptr<ASTNode>> inputTargets;
+    std::vector<ArenaPtr<ASTNode>> inputTargets;
 
-    explicit CinExpr(std::vector<std::unique_ptr<ASTNode>> targets)
+    explicit CinExpr(std::vector<ArenaPtr<ASTNode>> targets)
         : Expression(ASTNodeType::CIN_EXPR), inputTargets(std::move(targets)) {}
 };
 
 class CerrExpr : public Expression {
 public:
-    std::vector<std::unique_ptr<ASTNode>> errorOutputs;
+    std::vector<ArenaPtr<ASTNode>> errorOutputs;
 
-    explicit CerrExpr(std::vector<std::unique_ptr<ASTNode>> errors)
+    explicit CerrExpr(std::vector<ArenaPtr<ASTNode>> errors)
         : Expression(ASTNodeType::CERR_EXPR), errorOutputs(std::move(errors)) {}
 };
 
 class GetlineCall : public Expression {
 public:
-    std::unique_ptr<ASTNode> streamExpr; // e.g., std::cin
-    std::unique_ptr<ASTNode> targetVar;  // variable to store the line
+    ArenaPtr<ASTNode> streamExpr; // e.g., std::cin
+    ArenaPtr<ASTNode> targetVar;  // variable to store the line
 
-    GetlineCall(std::unique_ptr<ASTNode> stream, std::unique_ptr<ASTNode> target)
+    GetlineCall(ArenaPtr<ASTNode> stream, ArenaPtr<ASTNode> target)
         : Expression(ASTNodeType::GETLINE_CALL), streamExpr(std::move(stream)), targetVar(std::move(target)) {}
 };
 
 class PrintfCall : public Expression {
 public:
-    std::vector<std::unique_ptr<ASTNode>> arguments;
-    PrintfCall(std::vector<std::unique_ptr<ASTNode>> args)
+    std::vector<ArenaPtr<ASTNode>> arguments;
+    PrintfCall(std::vector<ArenaPtr<ASTNode>> args)
         : Expression(ASTNodeType::PRINTF_CALL), arguments(std::move(args)) {}
 };
 
 class ScanfCall : public Expression {
 public:
-    std::vector<std::unique_ptr<ASTNode>> inputTargets;
-    ScanfCall(std::vector<std::unique_ptr<ASTNode>> targets)
+    std::vector<ArenaPtr<ASTNode>> inputTargets;
+    ScanfCall(std::vector<ArenaPtr<ASTNode>> targets)
         : Expression(ASTNodeType::SCANF_CALL), inputTargets(std::move(targets)) {}
 };
 
 class NewExpr : public Expression {
 public:
-    std::unique_ptr<ASTNode> type;
-    std::vector<std::unique_ptr<ASTNode>> args;
+    ArenaPtr<ASTNode> type;
+    std::vector<ArenaPtr<ASTNode>> args;
 
-    NewExpr(std::unique_ptr<ASTNode> type, std::vector<std::unique_ptr<ASTNode>> args)
+    NewExpr(ArenaPtr<ASTNode> type, std::vector<ArenaPtr<ASTNode>> args)
         : Expression(ASTNodeType::NEW_EXPR), type(std::move(type)), args(std::move(args)) {}
 };
 
 class DeleteExpr : public Expression {
 public:
-    std::unique_ptr<ASTNode> expr;
+    ArenaPtr<ASTNode> expr;
 
-    explicit DeleteExpr(std::unique_ptr<ASTNode> expr)
+    explicit DeleteExpr(ArenaPtr<ASTNode> expr)
         : Expression(ASTNodeType::DELETE_EXPR), expr(std::move(expr)) {}
 };
 
 class MallocCall : public Expression {
 public:
-    std::unique_ptr<ASTNode> sizeExpr;
-    std::unique_ptr<ASTNode> elementType; // Add this line
+    ArenaPtr<ASTNode> sizeExpr;
+    ArenaPtr<ASTNode> elementType; // Add this line
 
-    MallocCall(std::unique_ptr<ASTNode> size, std::unique_ptr<ASTNode> elemType)
+    MallocCall(ArenaPtr<ASTNode> size, ArenaPtr<ASTNode> elemType)
         : Expression(ASTNodeType::MALLOC_CALL), sizeExpr(std::move(size)), elementType(std::move(elemType)) {}
 };
 
 class FreeCall : public Expression {
 public:
-    std::unique_ptr<ASTNode> ptrExpr;
-    FreeCall(std::unique_ptr<ASTNode> ptr)
+    ArenaPtr<ASTNode> ptrExpr;
+    FreeCall(ArenaPtr<ASTNode> ptr)
         : Expression(ASTNodeType::FREE_CALL), ptrExpr(std::move(ptr)) {}
 };
 
 class AbsCall : public Expression {
 public:
-    std::unique_ptr<ASTNode> valueExpr;
-    AbsCall(std::unique_ptr<ASTNode> val)
+    ArenaPtr<ASTNode> valueExpr;
+    AbsCall(ArenaPtr<ASTNode> val)
         : Expression(ASTNodeType::ABS_CALL), valueExpr(std::move(val)) {}
 };
 
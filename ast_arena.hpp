@@ -0,0 +1,94 @@
+#ifndef AST_ARENA_HPP
+#define AST_ARENA_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\arena.hpp"
+
+// Deleter for arena-allocated nodes: nothing to do, the AstArena owns them.
+struct ArenaDelete {
+    template <typename T>
+    void operator()(T*) const noexcept {}
+};
+
+// Non-owning link to an arena-allocated node. It keeps unique_ptr's
+// move-only handling (and Derived -> Base conversion), but destroying it
+// does not destroy the node, so tearing down a tree never recurses.
+template <typename T>
+using ArenaPtr = std::unique_ptr<T, ArenaDelete>;
+
+// Storage for one translation unit's AST.
+//
+// Nodes are bump-allocated from large chunks and released together: the
+// chunks go back in one step, and the nodes whose members own heap memory
+// (strings, child vectors) have their destructors run from a flat list, not
+// by walking the tree, so a deep tree cannot overflow the stack on the way
+// out. Every node made here must be dropped (or simply forgotten) before
+// the arena is released or destroyed. Not thread-safe.
+class AstArena {
+public:
+    AstArena() = default;
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+    ~AstArena() { release(); }
+
+    template <typename T, typename... Args>
+    ArenaPtr<T> make(Args&&... args) {
+        void* memory = arena_.allocate(sizeof(T), alignof(T));
+        T* node = new (memory) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            cleanups_.push_back(Cleanup{node, &destroy<T>});
+        }
+        nodeCount_++;
+        return ArenaPtr<T>(node);
+    }
+
+    // Destroy every node and return all memory at once
+    void release();
+
+    // Take ownership of every node made in other (which is left empty), so
+    // trees built in separate arenas, e.g. on worker threads, can be joined
+    void adopt(AstArena& other);
+
+    size_t nodeCount() const { return nodeCount_; }
+    size_t bytesReserved() const { return arena_.bytesReserved(); }
+
+private:
+    struct Cleanup {
+        void* object;
+        void (*destroy)(void*);
+    };
+
+    template <typename T>
+    static void destroy(void* object) {
+        static_cast<T*>(object)->~T();
+    }
+
+    Arena arena_;
+    std::vector<Cleanup> cleanups_;   // In creation order; run newest first
+    size_t nodeCount_ = 0;
+};
+
+inline void AstArena::release() {
+    for (size_t i = cleanups_.size(); i-- > 0;) {
+        cleanups_[i].destroy(cleanups_[i].object);
+    }
+    cleanups_.clear();
+    arena_.reset();
+    nodeCount_ = 0;
+}
+
+inline void AstArena::adopt(AstArena& other) {
+    if (&other == this) return;
+    arena_.adopt(other.arena_);
+    cleanups_.insert(cleanups_.end(), other.cleanups_.begin(), other.cleanups_.end());
+    nodeCount_ += other.nodeCount_;
+    other.cleanups_.clear();
+    other.nodeCount_ = 0;
+}
+
+#endif // AST_ARENA_HPP
@@ -0,0 +1,66 @@
+#ifndef CHAR_CLASS_HPP
+#define CHAR_CLASS_HPP
+
+#include <array>
+#include <cstdint>
+
+// Locale-independent character classification for the lexer.
+//
+// One 256-entry bitmask table replaces the <cctype> calls on the lexer's hot
+// paths: lookups are a single inlined load, and bytes >= 0x80 are safe to
+// classify (they simply belong to no class).
+namespace charclass {
+
+enum : uint8_t {
+    IdentStart    = 1 << 0,   // [A-Za-z_]
+    IdentContinue = 1 << 1,   // [A-Za-z0-9_]
+    Digit         = 1 << 2,   // [0-9]
+    Hex           = 1 << 3,   // [0-9A-Fa-f]
+    Space         = 1 << 4,   // ' ' \t \n \v \f \r
+    OperatorStart = 1 << 5,   // First byte of a punctuator
+};
+
+constexpr std::array<uint8_t, 256> buildTable() {
+    std::array<uint8_t, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        uint8_t bits = 0;
+        bool upper = c >= 'A' && c <= 'Z';
+        bool lower = c >= 'a' && c <= 'z';
+        bool digit = c >= '0' && c <= '9';
+        if (upper || lower || c == '_') bits |= IdentStart | IdentContinue;
+        if (digit) bits |= Digit | IdentContinue | Hex;
+        if ((c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f')) bits |= Hex;
+        if (c == ' ' || (c >= '\t' && c <= '\r')) bits |= Space;
+        table[c] = bits;
+    }
+    for (char c : {'+', '-', '*', '/', '%', '=', '!', '<', '>', '&', '|', '^', '~',
+                   '?', ':', ';', ',', '.', '(', ')', '{', '}', '[', ']', '#'}) {
+        table[static_cast<unsigned char>(c)] |= OperatorStart;
+    }
+    return table;
+}
+
+inline constexpr std::array<uint8_t, 256> kTable = buildTable();
+
+constexpr bool has(char c, uint8_t mask) {
+    return (kTable[static_cast<unsigned char>(c)] & mask) != 0;
+}
+
+constexpr bool isIdentStart(char c)    { return has(c, IdentStart); }
+constexpr bool isIdentContinue(char c) { return has(c, IdentContinue); }
+constexpr bool isDigit(char c)         { return has(c, Digit); }
+constexpr bool isHexDigit(char c)      { return has(c, Hex); }
+constexpr bool isSpace(char c)         { return has(c, Space); }
+constexpr bool isOperatorStart(char c) { return has(c, OperatorStart); }
+
+// Value of c as a digit of a base up to 16; 99, above every base, otherwise
+constexpr int digitValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return 99;
+}
+
+} // namespace charclass
+
+#endif // CHAR_CLASS_HPP
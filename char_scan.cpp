@@ -0,0 +1,250 @@
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\char_scan.hpp"
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SCAN_TARGET_SSE2
+#define SCAN_TARGET_AVX2
+#else
+#define SCAN_TARGET_SSE2 __attribute__((target("sse2")))
+#define SCAN_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace scan {
+namespace detail {
+
+namespace {
+
+inline unsigned countTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// --- Scalar kernels ---
+
+size_t whitespaceRunScalar(const char* p, const char* end) {
+    const char* q = p;
+    while (q < end && isSpaceByte(*q)) ++q;
+    return q - p;
+}
+
+const char* findCommentEndScalar(const char* p, const char* end) {
+    for (; p + 1 < end; ++p) {
+        if (p[0] == '*' && p[1] == '/') return p;
+    }
+    return end;
+}
+
+const char* findLiteralStopScalar(const char* p, const char* end, char quote) {
+    for (; p < end; ++p) {
+        if (*p == quote || *p == '\\' || *p == '\n') return p;
+    }
+    return end;
+}
+
+inline bool isSkipStop(char c) {
+    return c == '\n' || c == '/' || c == '"' || c == '\'' || c == '\\';
+}
+
+const char* findSkipStopScalar(const char* p, const char* end) {
+    while (p < end && !isSkipStop(*p)) ++p;
+    return p;
+}
+
+#ifdef SCAN_X86
+
+// --- SSE2 kernels (16 bytes per step) ---
+
+SCAN_TARGET_SSE2 inline uint32_t spaceMask16(__m128i bytes) {
+    // ' ' or '\t'..'\r' (unsigned bytes - 9 <= 4)
+    __m128i isBlank = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+    __m128i shifted = _mm_sub_epi8(bytes, _mm_set1_epi8('\t'));
+    __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(4)), shifted);
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(isBlank, isControl)));
+}
+
+SCAN_TARGET_SSE2 size_t whitespaceRunSse2(const char* p, const char* end) {
+    const char* q = p;
+    while (end - q >= 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(q));
+        uint32_t other = ~spaceMask16(bytes) & 0xFFFFu;
+        if (other) return (q - p) + countTrailingZeros(other);
+        q += 16;
+    }
+    return (q - p) + whitespaceRunScalar(q, end);
+}
+
+SCAN_TARGET_SSE2 const char* findCommentEndSse2(const char* p, const char* end) {
+    // Need 17 readable bytes: the '*' block and the '/' block shifted by one
+    while (end - p >= 17) {
+        __m128i stars = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)),
+                                       _mm_set1_epi8('*'));
+        __m128i slashes = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1)),
+                                         _mm_set1_epi8('/'));
+        uint32_t hits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(stars, slashes)));
+        if (hits) return p + countTrailingZeros(hits);
+        p += 16;
+    }
+    return findCommentEndScalar(p, end);
+}
+
+SCAN_TARGET_SSE2 const char* findLiteralStopSse2(const char* p, const char* end, char quote) {
+    const __m128i quotes = _mm_set1_epi8(quote);
+    const __m128i backslashes = _mm_set1_epi8('\\');
+    const __m128i newlines = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i stops = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, quotes),
+                                                  _mm_cmpeq_epi8(bytes, backslashes)),
+                                     _mm_cmpeq_epi8(bytes, newlines));
+        uint32_t hits = static_cast<uint32_t>(_mm_movemask_epi8(stops));
+        if (hits) return p + countTrailingZeros(hits);
+        p += 16;
+    }
+    return findLiteralStopScalar(p, end, quote);
+}
+
+SCAN_TARGET_SSE2 const char* findSkipStopSse2(const char* p, const char* end) {
+    while (end - p >= 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i stops = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')),
+                         _mm_cmpeq_epi8(bytes, _mm_set1_epi8('/'))),
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('"')),
+                                      _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\''))),
+                         _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\\'))));
+        uint32_t hits = static_cast<uint32_t>(_mm_movemask_epi8(stops));
+        if (hits) return p + countTrailingZeros(hits);
+        p += 16;
+    }
+    return findSkipStopScalar(p, end);
+}
+
+// --- AVX2 kernels (32 bytes per step) ---
+
+SCAN_TARGET_AVX2 inline uint32_t spaceMask32(__m256i bytes) {
+    __m256i isBlank = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' '));
+    __m256i shifted = _mm256_sub_epi8(bytes, _mm256_set1_epi8('\t'));
+    __m256i isControl = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(4)), shifted);
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(isBlank, isControl)));
+}
+
+SCAN_TARGET_AVX2 size_t whitespaceRunAvx2(const char* p, const char* end) {
+    const char* q = p;
+    while (end - q >= 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q));
+        uint32_t other = ~spaceMask32(bytes);
+        if (other) return (q - p) + countTrailingZeros(other);
+        q += 32;
+    }
+    return (q - p) + whitespaceRunSse2(q, end);
+}
+
+SCAN_TARGET_AVX2 const char* findCommentEndAvx2(const char* p, const char* end) {
+    while (end - p >= 33) {
+        __m256i stars = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)),
+                                          _mm256_set1_epi8('*'));
+        __m256i slashes = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1)),
+                                            _mm256_set1_epi8('/'));
+        uint32_t hits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(stars, slashes)));
+        if (hits) return p + countTrailingZeros(hits);
+        p += 32;
+    }
+    return findCommentEndSse2(p, end);
+}
+
+SCAN_TARGET_AVX2 const char* findLiteralStopAvx2(const char* p, const char* end, char quote) {
+    const __m256i quotes = _mm256_set1_epi8(quote);
+    const __m256i backslashes = _mm256_set1_epi8('\\');
+    const __m256i newlines = _mm256_set1_epi8('\n');
+    while (end - p >= 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i stops = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, quotes),
+                                                        _mm256_cmpeq_epi8(bytes, backslashes)),
+                                        _mm256_cmpeq_epi8(bytes, newlines));
+        uint32_t hits = static_cast<uint32_t>(_mm256_movemask_epi8(stops));
+        if (hits) return p + countTrailingZeros(hits);
+        p += 32;
+    }
+    return findLiteralStopSse2(p, end, quote);
+}
+
+SCAN_TARGET_AVX2 const char* findSkipStopAvx2(const char* p, const char* end) {
+    while (end - p >= 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i stops = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n')),
+                            _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('/'))),
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('"')),
+                                            _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\''))),
+                            _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\\'))));
+        uint32_t hits = static_cast<uint32_t>(_mm256_movemask_epi8(stops));
+        if (hits) return p + countTrailingZeros(hits);
+        p += 32;
+    }
+    return findSkipStopSse2(p, end);
+}
+
+// --- CPU feature detection ---
+
+bool cpuHasSse2() {
+#if defined(__x86_64__) || defined(_M_X64)
+    return true;   // Part of the x86-64 baseline
+#elif defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) &&
+                      ((_xgetbv(0) & 0x6) == 0x6);
+    if (!osSavesYmm) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // SCAN_X86
+
+Kernels selectKernels() {
+#ifdef SCAN_X86
+    if (cpuHasAvx2()) {
+        return {"avx2", whitespaceRunAvx2, findCommentEndAvx2, findLiteralStopAvx2, findSkipStopAvx2};
+    }
+    if (cpuHasSse2()) {
+        return {"sse2", whitespaceRunSse2, findCommentEndSse2, findLiteralStopSse2, findSkipStopSse2};
+    }
+#endif
+    return {"scalar", whitespaceRunScalar, findCommentEndScalar, findLiteralStopScalar, findSkipStopScalar};
+}
+
+} // unnamed namespace
+
+const Kernels& kernels() {
+    static const Kernels selected = selectKernels();
+    return selected;
+}
+
+} // namespace detail
+} // namespace scan
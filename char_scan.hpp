@@ -0,0 +1,90 @@
+#ifndef CHAR_SCAN_HPP
+#define CHAR_SCAN_HPP
+
+#include <cstddef>
+#include <cstring>
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\char_class.hpp"
+
+// Bulk byte scanners used by the lexer's hot loops.
+//
+// Each scanner has an SSE2 and an AVX2 kernel on x86 plus a portable scalar
+// fallback; the widest kernel the CPU supports is picked once at startup.
+// The inline wrappers below handle short runs themselves so the common
+// "one space between tokens" case never pays for an indirect call.
+namespace scan {
+
+// C-locale isspace(): ' ', '\t', '\n', '\v', '\f', '\r'
+inline bool isSpaceByte(char c) {
+    return charclass::isSpace(c);
+}
+
+namespace detail {
+
+struct Kernels {
+    const char* name;
+    size_t (*whitespaceRun)(const char* p, const char* end);
+    const char* (*findCommentEnd)(const char* p, const char* end);
+    const char* (*findLiteralStop)(const char* p, const char* end, char quote);
+    const char* (*findSkipStop)(const char* p, const char* end);
+};
+
+const Kernels& kernels();   // Selected once, on first use
+
+constexpr size_t kInlineLimit = 16;   // Runs shorter than this are handled inline
+
+} // namespace detail
+
+// Name of the selected kernel set ("avx2", "sse2" or "scalar")
+inline const char* kernelName() { return detail::kernels().name; }
+
+// Number of whitespace bytes starting at p (never reads at or past end)
+inline size_t whitespaceRun(const char* p, const char* end) {
+    const char* q = p;
+    while (q < end && isSpaceByte(*q)) {
+        if (static_cast<size_t>(q - p) == detail::kInlineLimit) {
+            return (q - p) + detail::kernels().whitespaceRun(q, end);
+        }
+        ++q;
+    }
+    return q - p;
+}
+
+// Position of the first "*/" at or after p, or end if the comment is unterminated
+inline const char* findCommentEnd(const char* p, const char* end) {
+    return detail::kernels().findCommentEnd(p, end);
+}
+
+// Position of the first '\n' at or after p, or end
+inline const char* findNewline(const char* p, const char* end) {
+    const void* hit = std::memchr(p, '\n', end - p);
+    return hit ? static_cast<const char*>(hit) : end;
+}
+
+// Length of the line splice at p: a backslash, then '\n' or "\r\n" (CRLF
+// sources). 0 if there is none.
+inline size_t spliceLength(const char* p, const char* end) {
+    if (end - p < 2 || p[0] != '\\') return 0;
+    if (p[1] == '\n') return 2;
+    return (end - p >= 3 && p[1] == '\r' && p[2] == '\n') ? 3 : 0;
+}
+
+// Position of the first quote, '\\' or '\n' at or after p, or end.
+// Used to slice string and char literals without visiting every byte.
+inline const char* findLiteralStop(const char* p, const char* end, char quote) {
+    const char* limit = (static_cast<size_t>(end - p) > detail::kInlineLimit) ? p + detail::kInlineLimit : end;
+    for (; p < limit; ++p) {
+        if (*p == quote || *p == '\\' || *p == '\n') return p;
+    }
+    return p == end ? end : detail::kernels().findLiteralStop(p, end, quote);
+}
+
+// Position of the first byte at or after p that matters inside a skipped
+// #if region: '\n', '/', '"', '\'' or '\\' (or end). Everything else is
+// inactive text that can be jumped over.
+inline const char* findSkipStop(const char* p, const char* end) {
+    return detail::kernels().findSkipStop(p, end);
+}
+
+} // namespace scan
+
+#endif // CHAR_SCAN_HPP
@@ -0,0 +1,52 @@
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\include_resolver.hpp"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+IncludeResolver::IncludeResolver(std::vector<std::string> searchPaths)
+    : searchPaths_(std::move(searchPaths)) {}
+
+void IncludeResolver::addSearchPath(std::string directory) {
+    searchPaths_.push_back(std::move(directory));
+}
+
+SourceFile* IncludeResolver::resolve(std::string_view name, bool angled, std::string_view includerPath) {
+    if (name.empty()) return nullptr;
+
+    if (!angled) {
+        fs::path dir = fs::path(std::string(includerPath)).parent_path();
+        if (SourceFile* file = load((dir / std::string(name)).lexically_normal().string())) {
+            return file;
+        }
+    }
+    for (const std::string& dir : searchPaths_) {
+        if (SourceFile* file = load((fs::path(dir) / std::string(name)).lexically_normal().string())) {
+            return file;
+        }
+    }
+    return nullptr;
+}
+
+const SourceFile* IncludeResolver::file(uint16_t id) const {
+    if (id == 0 || id > files_.size()) return nullptr;
+    return &files_[id - 1];
+}
+
+SourceFile* IncludeResolver::load(const std::string& path) {
+    auto it = byPath_.find(path);
+    if (it != byPath_.end()) return it->second;
+
+    SourceFile* result = nullptr;
+    SourceBuffer buffer;
+    std::error_code error;
+    if (files_.size() < kMaxFiles && fs::is_regular_file(path, error) && buffer.open(path)) {
+        SourceFile& file = files_.emplace_back();
+        file.id = static_cast<uint16_t>(files_.size());
+        file.path = path;
+        file.buffer = std::move(buffer);
+        file.lines = LineIndex(file.buffer.view());
+        result = &file;
+    }
+    byPath_.emplace(path, result);
+    return result;
+}
@@ -0,0 +1,55 @@
+#ifndef INCLUDE_RESOLVER_HPP
+#define INCLUDE_RESOLVER_HPP
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\source_buffer.hpp"
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\line_index.hpp"
+
+// A file pulled in by #include. It is read once per run and kept until the
+// resolver goes away; tokens lexed from it view straight into buffer.
+struct SourceFile {
+    uint16_t id = 0;            // Token::file() of its tokens (0 is reserved for the main source)
+    std::string path;           // Normalized path it was opened under
+    SourceBuffer buffer;
+    LineIndex lines;
+
+    // Multiple-include optimization, filled in by the Lexer the first time
+    // through: once either is known, later #includes skip the file unread.
+    bool pragmaOnce = false;    // Saw "#pragma once"
+    std::string_view guard;     // Macro of an #ifndef/#define/#endif guard wrapping the whole file
+};
+
+// Finds #include targets and caches them for every Lexer that shares it.
+//
+// "name" is looked up next to the including file first, then in the search
+// paths in order; <name> only in the search paths. Lookups that fail are
+// remembered too, so a missing system header costs one probe per directory.
+// Not thread-safe.
+class IncludeResolver {
+public:
+    static constexpr size_t kMaxFiles = UINT16_MAX;   // File ids must fit Token::file()
+
+    explicit IncludeResolver(std::vector<std::string> searchPaths = {});
+
+    void addSearchPath(std::string directory);
+
+    // nullptr if the file cannot be found (or the id space is exhausted)
+    SourceFile* resolve(std::string_view name, bool angled, std::string_view includerPath);
+
+    const SourceFile* file(uint16_t id) const;   // nullptr for 0 or an unknown id
+    size_t filesRead() const { return files_.size(); }
+
+private:
+    std::vector<std::string> searchPaths_;
+    std::deque<SourceFile> files_;                          // files_[id - 1]; deque keeps them in place
+    std::unordered_map<std::string, SourceFile*> byPath_;   // Normalized path -> file (nullptr: missing)
+
+    SourceFile* load(const std::string& path);
+};
+
+#endif // INCLUDE_RESOLVER_HPP
@@ -0,0 +1,168 @@
+#ifndef KEYWORDS_HPP
+#define KEYWORDS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\tokens.hpp"
+
+// Keyword and library-name spellings recognized by the lexer. This list is
+// the single source of truth: the lookup table below is generated from it
+// at compile time.
+struct KeywordEntry {
+    std::string_view spelling;
+    TokenType type;
+};
+
+inline constexpr KeywordEntry kKeywords[] = {
+    // C++ keywords
+    {"int", TokenType::INT}, {"void", TokenType::VOID}, {"char", TokenType::CHAR},
+    {"float", TokenType::FLOAT_TYPE}, {"double", TokenType::DOUBLE}, {"bool", TokenType::BOOL},
+    {"class", TokenType::CLASS}, {"struct", TokenType::STRUCT}, {"enum", TokenType::ENUM},
+    {"union", TokenType::UNION}, {"const", TokenType::CONST}, {"unsigned", TokenType::UNSIGNED},
+    {"signed", TokenType::SIGNED}, {"short", TokenType::SHORT}, {"long", TokenType::LONG},
+    {"static", TokenType::STATIC}, {"extern", TokenType::EXTERN}, {"register", TokenType::REGISTER},
+    {"inline", TokenType::INLINE}, {"virtual", TokenType::VIRTUAL}, {"explicit", TokenType::EXPLICIT},
+    {"friend", TokenType::FRIEND}, {"private", TokenType::PRIVATE}, {"public", TokenType::PUBLIC},
+    {"protected", TokenType::PROTECTED}, {"if", TokenType::IF}, {"else", TokenType::ELSE},
+    {"for", TokenType::FOR}, {"while", TokenType::WHILE}, {"do", TokenType::DO},
+    {"switch", TokenType::SWITCH}, {"case", TokenType::CASE}, {"default", TokenType::DEFAULT},
+    {"break", TokenType::BREAK}, {"continue", TokenType::CONTINUE}, {"return", TokenType::RETURN},
+    {"goto", TokenType::GOTO}, {"namespace", TokenType::NAMESPACE}, {"using", TokenType::USING},
+    {"template", TokenType::TEMPLATE}, {"typedef", TokenType::TYPEDEF},
+
+    // STL Containers
+    {"vector", TokenType::VECTOR}, {"map", TokenType::MAP}, {"set", TokenType::SET},
+    {"list", TokenType::LIST}, {"deque", TokenType::DEQUE}, {"unordered_map", TokenType::UNORDERED_MAP},
+    {"unordered_set", TokenType::UNORDERED_SET}, {"multimap", TokenType::MULTIMAP},
+    {"multiset", TokenType::MULTISET}, {"stack", TokenType::STACK}, {"queue", TokenType::QUEUE},
+    {"priority_queue", TokenType::PRIORITY_QUEUE}, {"bitset", TokenType::BITSET},
+    {"array", TokenType::ARRAY}, {"forward_list", TokenType::FORWARD_LIST},
+    {"pair", TokenType::PAIR}, {"tuple", TokenType::TUPLE}, {"string", TokenType::STRING_LIB},
+    {"optional", TokenType::OPTIONAL}, {"variant", TokenType::VARIANT}, {"any", TokenType::ANY},
+    {"span", TokenType::SPAN}, {"valarray", TokenType::VALARRAY},
+
+    // C standard lib functions
+    {"printf", TokenType::PRINTF}, {"scanf", TokenType::SCANF}, {"malloc", TokenType::MALLOC},
+    {"free", TokenType::FREE}, {"memcpy", TokenType::MEMCPY}, {"strcpy", TokenType::STRCPY},
+    {"strlen", TokenType::STRLEN},
+
+    // C++ I/O Streams
+    {"cin", TokenType::CIN}, {"cout", TokenType::COUT}, {"cerr", TokenType::CERR}, {"clog", TokenType::CLIN},
+
+    // Algorithms
+    {"sort", TokenType::SORT}, {"find", TokenType::FIND}, {"count", TokenType::COUNT}, {"copy", TokenType::COPY},
+    {"reverse", TokenType::REVERSE}, {"accumulate", TokenType::ACCUMULATE},
+    {"all_of", TokenType::ALL_OF}, {"any_of", TokenType::ANY_OF}, {"none_of", TokenType::NONE_OF},
+    {"lower_bound", TokenType::LOWER_BOUND}, {"upper_bound", TokenType::UPPER_BOUND},
+
+    // Math
+    {"abs", TokenType::ABS}, {"fabs", TokenType::FABS}, {"pow", TokenType::POW}, {"sqrt", TokenType::SQRT},
+    {"sin", TokenType::SIN}, {"cos", TokenType::COS}, {"tan", TokenType::TAN},
+    {"floor", TokenType::FLOOR}, {"ceil", TokenType::CEIL}, {"round", TokenType::ROUND},
+    {"rand", TokenType::RAND}, {"srand", TokenType::SRAND}, {"exit", TokenType::EXIT},
+
+    // Strings
+    {"stoi", TokenType::STOI}, {"stof", TokenType::STOF}, {"stod", TokenType::STOD}, {"to_string", TokenType::TO_STRING},
+    {"strcmp", TokenType::STRCMP}, {"strncmp", TokenType::STRNCMP}, {"strchr", TokenType::STRCHR},
+    {"strrchr", TokenType::STRRCHR}, {"strstr", TokenType::STRSTR}, {"strcat", TokenType::STRCAT},
+    {"strncat", TokenType::STRNCAT},
+
+    // Memory and allocation
+    {"new", TokenType::NEW}, {"delete", TokenType::DELETE}, {"allocate", TokenType::ALLOCATE}, {"deallocate", TokenType::DEALLOCATE},
+
+    // Time
+    {"time", TokenType::TIME}, {"clock", TokenType::CLOCK}, {"difftime", TokenType::DIFFTIME},
+    {"strftime", TokenType::STRFTIME}, {"localtime", TokenType::LOCALTIME}, {"gmtime", TokenType::GMTIME},
+
+    // Concurrency
+    {"thread", TokenType::THREAD}, {"mutex", TokenType::MUTEX}, {"lock_guard", TokenType::LOCK_GUARD},
+    {"unique_lock", TokenType::UNIQUE_LOCK}, {"async", TokenType::ASYNC}, {"future", TokenType::FUTURE},
+    {"promise", TokenType::PROMISE},
+
+    // Exceptions
+    {"try", TokenType::TRY}, {"catch", TokenType::CATCH}, {"throw", TokenType::THROW},
+    {"exception", TokenType::EXCEPTION}, {"logic_error", TokenType::LOGIC_ERROR}, {"runtime_error", TokenType::RUNTIME_ERROR},
+
+    // RTTI / Casting
+    {"typeid", TokenType::TYPEID}, {"static_cast", TokenType::STATIC_CAST}, {"dynamic_cast", TokenType::DYNAMIC_CAST},
+    {"const_cast", TokenType::CONST_CAST}, {"reinterpret_cast", TokenType::REINTERPRET_CAST}
+};
+
+inline constexpr size_t kKeywordCount = sizeof(kKeywords) / sizeof(kKeywords[0]);
+
+// --- Compile-time perfect hash ---
+// FNV-1a over the raw bytes, salted with a seed. buildKeywordTable() tries
+// seeds until every keyword lands in its own slot, so a lookup is one hash,
+// one table load and one length-checked compare, with no allocation.
+namespace keyword_detail {
+
+constexpr size_t kTableBits = 12;
+constexpr size_t kTableSize = size_t(1) << kTableBits;
+constexpr uint32_t kTableMask = static_cast<uint32_t>(kTableSize - 1);
+
+constexpr uint32_t hash(const char* s, size_t n, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed ^ static_cast<uint32_t>(n);
+    for (size_t i = 0; i < n; ++i) {
+        h = (h ^ static_cast<unsigned char>(s[i])) * 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+struct Table {
+    uint32_t seed = 0;
+    size_t minLength = 0;
+    size_t maxLength = 0;
+    uint8_t slots[kTableSize] = {};   // 0 = empty, otherwise index into kKeywords + 1
+};
+
+constexpr bool tryBuild(Table& table) {
+    for (size_t i = 0; i < kKeywordCount; ++i) {
+        std::string_view s = kKeywords[i].spelling;
+        uint32_t slot = hash(s.data(), s.size(), table.seed) & kTableMask;
+        if (table.slots[slot] != 0) return false;
+        table.slots[slot] = static_cast<uint8_t>(i + 1);
+    }
+    return true;
+}
+
+constexpr Table buildKeywordTable() {
+    for (uint32_t seed = 1;; ++seed) {
+        Table table;
+        table.seed = seed;
+        if (tryBuild(table)) {
+            table.minLength = kKeywords[0].spelling.size();
+            for (size_t i = 0; i < kKeywordCount; ++i) {
+                size_t n = kKeywords[i].spelling.size();
+                if (n < table.minLength) table.minLength = n;
+                if (n > table.maxLength) table.maxLength = n;
+            }
+            return table;
+        }
+    }
+}
+
+static_assert(kKeywordCount < 255, "keyword index must fit in a table slot");
+
+inline constexpr Table kTable = buildKeywordTable();
+
+} // namespace keyword_detail
+
+// Classify an identifier spelling: the keyword's TokenType, or IDENTIFIER.
+constexpr TokenType lookupKeyword(std::string_view text) {
+    using namespace keyword_detail;
+    if (text.size() < kTable.minLength || text.size() > kTable.maxLength) {
+        return TokenType::IDENTIFIER;
+    }
+    uint8_t entry = kTable.slots[hash(text.data(), text.size(), kTable.seed) & kTableMask];
+    if (entry != 0 && kKeywords[entry - 1].spelling == text) {
+        return kKeywords[entry - 1].type;
+    }
+    return TokenType::IDENTIFIER;
+}
+
+static_assert(lookupKeyword("int") == TokenType::INT, "keyword table out of sync");
+static_assert(lookupKeyword("reinterpret_cast") == TokenType::REINTERPRET_CAST, "keyword table out of sync");
+static_assert(lookupKeyword("integer") == TokenType::IDENTIFIER, "keyword table out of sync");
+
+#endif // KEYWORDS_HPP
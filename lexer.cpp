@@ -1,58 +1,444 @@
 #include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\lexer.hpp"
-#include <cctype>
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\keywords.hpp"
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\punctuators.hpp"
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\char_scan.hpp"
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\char_class.hpp"
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <cstdint>
 
 // === Constructor ===
 
-Lexer::Lexer(const std::string& source)
-    : source_(source), pos_(0), line_(1), column_(1), skipping_(false) {
-    conditionalStack_.push_back(true);
+Lexer::Lexer(std::string_view source)
+    : source_(source), pos_(0), lineIndex_(source), skipping_(false) {
+    conditionalStack_.push_back(Conditional{true, true});
 }
 
 // === Tokenization main loop ===
 
-std::vector<std::unique_ptr<Token>> Lexer::tokenize() {
-    std::vector<std::unique_ptr<Token>> tokens;
+std::vector<Token> Lexer::tokenize() {
+    std::vector<Token> tokens;
+    tokens.reserve(source_.size() / 8 + 16);   // Typical code runs 4-7 bytes per token
     while (true) {
+        tokens.push_back(nextToken());
+        if (tokens.back().type() == TokenType::END_OF_FILE) break;
+    }
+    return tokens;
+}
+
+TokenBuffer Lexer::tokenizePacked() {
+    TokenBuffer tokens(source_, includes_);
+    tokens.reserve(source_.size() / 8 + 16);
+    while (true) {
+        Token token = nextToken();
+        tokens.push_back(token);
+        if (token.type() == TokenType::END_OF_FILE) break;
+    }
+    return tokens;
+}
+
+// === Parallel tokenization ===
+//
+// Workers lex their chunk assuming it starts outside any comment, literal or
+// skipped #if region, with no macros defined, and they step over directive
+// lines without interpreting them. Nothing they produce is trusted blindly:
+// the sequential pass below (an ordinary tokenize()) adopts a speculative
+// token only when it reaches that exact offset itself while not skipping,
+// so a wrong guess about the starting state just means re-lexing that stretch.
+
+std::vector<Token> Lexer::tokenizeParallel(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (threadCount < 2 || source_.size() < kParallelMinBytes || pos_ != 0 || lookaheadCount_ != 0) {
+        return tokenize();
+    }
+
+    // Chunk boundaries sit just past a newline
+    const char* begin = source_.data();
+    const char* end = begin + source_.size();
+    std::vector<size_t> bounds{0};
+    size_t chunkSize = source_.size() / threadCount;
+    for (unsigned i = 1; i < threadCount; ++i) {
+        size_t from = std::max(bounds.back(), i * chunkSize);
+        const char* newline = scan::findNewline(begin + from, end);
+        if (newline == end) break;
+        bounds.push_back((newline + 1) - begin);
+    }
+    bounds.push_back(source_.size());
+
+    size_t chunks = bounds.size() - 1;
+    std::vector<std::vector<Token>> chunkTokens(chunks);
+    std::vector<std::vector<uint32_t>> chunkResume(chunks);
+    std::vector<std::thread> workers;
+    workers.reserve(chunks);
+    for (size_t i = 0; i < chunks; ++i) {
+        workers.emplace_back([this, &bounds, &chunkTokens, &chunkResume, i, chunks] {
+            speculateChunk(bounds[i], bounds[i + 1], i + 1 == chunks, chunkTokens[i], chunkResume[i]);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    size_t total = 0;
+    for (const auto& tokens : chunkTokens) total += tokens.size();
+    speculative_.reserve(total);
+    speculativeResume_.reserve(total);
+    for (size_t i = 0; i < chunks; ++i) {
+        speculative_.insert(speculative_.end(), chunkTokens[i].begin(), chunkTokens[i].end());
+        speculativeResume_.insert(speculativeResume_.end(), chunkResume[i].begin(), chunkResume[i].end());
+    }
+    speculativeCursor_ = 0;
+
+    std::vector<Token> tokens = tokenize();
+
+    speculative_.clear();
+    speculativeResume_.clear();
+    speculativeCursor_ = 0;
+    return tokens;
+}
+
+void Lexer::speculateChunk(size_t begin, size_t end, bool last,
+                           std::vector<Token>& tokens, std::vector<uint32_t>& resume) const {
+    // A private lexer over [0, end) so views and offsets stay absolute
+    Lexer worker(source_.substr(0, end));
+    worker.pos_ = begin;
+    worker.internSymbols_ = false;   // The interner is not thread-safe; see takeSpeculative()
+
+    worker.skipWhitespaceAndComments();
+    while (worker.pos_ < end) {
+        if (worker.source_[worker.pos_] == '#') {
+            // Directives are for the real lexer; carry on from the next line
+            const char* data = worker.source_.data();
+            const char* newline = scan::findNewline(data + worker.pos_, data + end);
+            if (newline == data + end) break;
+            worker.pos_ = (newline + 1) - data;
+            worker.skipWhitespaceAndComments();
+            continue;
+        }
+
+        Token token = worker.lexToken();
+        if (worker.pos_ >= end && !last) {
+            break;   // May have been cut short by the chunk boundary
+        }
+        tokens.push_back(token);
+
+        // Resume past the following whitespace unless it ran into the chunk
+        // end, where the real lexer may be inside a comment that continues.
+        size_t tokenEnd = worker.pos_;
+        worker.skipWhitespaceAndComments();
+        resume.push_back(static_cast<uint32_t>(worker.pos_ < end ? worker.pos_ : tokenEnd));
+    }
+}
+
+bool Lexer::takeSpeculative(Token& token) {
+    if (!includeStack_.empty()) {
+        return false;   // Speculation only covers the main source
+    }
+    while (speculativeCursor_ < speculative_.size() &&
+           speculative_[speculativeCursor_].offset() < pos_) {
+        speculativeCursor_++;
+    }
+    if (speculativeCursor_ == speculative_.size() ||
+        speculative_[speculativeCursor_].offset() != pos_) {
+        return false;
+    }
+    token = speculative_[speculativeCursor_];
+    if (token.type() == TokenType::IDENTIFIER) {
+        token.set_symbol(intern(token.view()));
+    }
+    pos_ = speculativeResume_[speculativeCursor_];
+    speculativeCursor_++;
+    return true;
+}
+
+// === Incremental re-lexing ===
+
+namespace {
+
+bool isDirectiveToken(TokenType type) {
+    return type >= TokenType::PREPROCESSOR_INCLUDE && type <= TokenType::PREPROCESSOR_UNKNOWN;
+}
+
+bool isConditionalDirective(std::string_view name) {
+    return name == "if" || name == "ifdef" || name == "ifndef" ||
+           name == "elif" || name == "else" || name == "endif";
+}
+
+} // unnamed namespace
+
+RelexResult Lexer::relex(const std::vector<Token>& previous, std::string_view newSource,
+                         size_t editStart, size_t oldEditEnd, size_t newEditEnd) {
+    const char* oldBase = source_.data();
+    size_t oldSize = source_.size();
+    const char* newBase = newSource.data();
+    long long delta = static_cast<long long>(newEditEnd) - static_cast<long long>(oldEditEnd);
+
+    // Offset in the new source of a token that lay outside the edit
+    auto shifted = [&](const Token& token) -> size_t {
+        return token.offset() >= oldEditEnd ? token.offset() + delta : token.offset();
+    };
+    // Carry a token over, moving views into the old buffer along with it.
+    // Views elsewhere (owned text, static messages) stay as they are.
+    auto carry = [&](const Token& token) {
+        const char* text = token.view().data();
+        if (text >= oldBase && text <= oldBase + oldSize) {
+            size_t at = text - oldBase;
+            text = newBase + (at >= oldEditEnd ? at + delta : at);
+        }
+        return token.relocated(text, static_cast<uint32_t>(shifted(token)));
+    };
+
+    source_ = newSource;
+    lineIndex_ = LineIndex(newSource);
+    lookaheadHead_ = 0;
+    lookaheadCount_ = 0;
+
+    // Restart one token before the first token at or past the edit, in case
+    // the edit extends it (e.g. typing at the end of an identifier).
+    size_t restart = 0;
+    while (restart < previous.size() && previous[restart].offset() < editStart) restart++;
+    if (restart > 0) restart--;
+    // A macro expansion is one unit: its tokens all share the use's offset
+    while (restart > 0 && previous[restart - 1].offset() == previous[restart].offset()) restart--;
+
+    // Rebuild the preprocessor state at the restart point; the text before
+    // the edit is unchanged, so replaying its directives gives the same state.
+    macros_.clear();
+    macroFilter_.clear();
+    macroGeneration_++;
+    pending_.clear();
+    pendingIndex_ = 0;
+    conditionalStack_.assign(1, Conditional{true, true});
+    skipping_ = false;
+    includeStack_.clear();
+    entered_.clear();
+    file_ = 0;
+
+    // Offsets into other files say nothing about the edit; start over
+    bool fromIncludes = std::any_of(previous.begin(), previous.end(),
+                                    [](const Token& token) { return token.file() != 0; });
+    if (fromIncludes) {
+        pos_ = 0;
+        RelexResult result;
+        result.tokens = tokenize();
+        result.lastChanged = result.tokens.size();
+        result.replacedEnd = previous.size();
+        return result;
+    }
+
+    // No header was read last time, so none needs to be while replaying
+    IncludeResolver* resolver = std::exchange(includes_, nullptr);
+    for (size_t i = 0; i < restart; ++i) {
+        if (isDirectiveToken(previous[i].type())) {
+            pos_ = previous[i].offset();
+            lexPreprocessorDirective();
+        }
+    }
+    includes_ = resolver;
+
+    RelexResult result;
+    result.tokens.reserve(previous.size());
+    for (size_t i = 0; i < restart; ++i) {
+        result.tokens.push_back(carry(previous[i]));
+    }
+    result.firstChanged = restart;
+
+    pos_ = restart > 0 ? previous[restart].offset() : 0;   // Nothing safe before the first token
+    size_t old = restart;          // Candidate in previous to resynchronize with
+    bool directiveTouched = false; // Preprocessor state may now differ: no resync
+    bool restartAtDirective = restart > 0 && isDirectiveToken(previous[restart].type());
+    while (true) {
+        // A directive inside a skipped region is only found by scanning from
+        // the start of its line, so when restarting on one, lex it directly.
+        Token token;
+        if (restartAtDirective) {
+            restartAtDirective = false;
+            if (!lexDirective(token)) continue;
+        } else {
+            token = nextToken();
+        }
+        if (isDirectiveToken(token.type())) directiveTouched = true;
+
+        // Tokens from a macro expansion share the offset of the use, so only
+        // a token read straight from the source can line up the streams.
+        if (!directiveTouched && !lastFromExpansion_ && token.offset() >= newEditEnd) {
+            while (old < previous.size() && shifted(previous[old]) < token.offset()) {
+                if (isDirectiveToken(previous[old].type())) directiveTouched = true;
+                old++;
+            }
+            // Same state, same offset, identical bytes from here on: the rest
+            // of the old stream is still valid.
+            if (!directiveTouched && old < previous.size() &&
+                previous[old].offset() >= oldEditEnd &&
+                shifted(previous[old]) == token.offset() &&
+                previous[old].type() == token.type()) {
+                break;
+            }
+        }
+
+        result.tokens.push_back(token);
+        if (token.type() == TokenType::END_OF_FILE) {
+            old = previous.size();
+            break;
+        }
+    }
+
+    result.lastChanged = result.tokens.size();
+    result.replacedEnd = old;
+    for (size_t i = old; i < previous.size(); ++i) {
+        result.tokens.push_back(carry(previous[i]));
+    }
+    pos_ = source_.size();
+    return result;
+}
+
+// === Streaming interface ===
+
+Token Lexer::nextToken() {
+    if (lookaheadCount_ > 0) {
+        Token token = lookahead_[lookaheadHead_];
+        lookaheadHead_ = (lookaheadHead_ + 1) % kMaxLookahead;
+        lookaheadCount_--;
+        return token;
+    }
+    return lexNext();
+}
+
+const Token& Lexer::peekToken(size_t k) {
+    if (k >= kMaxLookahead) {
+        throw std::out_of_range("peekToken: lookahead exceeds kMaxLookahead");
+    }
+    while (lookaheadCount_ <= k) {
+        lookahead_[(lookaheadHead_ + lookaheadCount_) % kMaxLookahead] = lexNext();
+        lookaheadCount_++;
+    }
+    return lookahead_[(lookaheadHead_ + k) % kMaxLookahead];
+}
+
+Token Lexer::lexNext() {
+    while (true) {
+        if (pendingIndex_ < pending_.size()) {
+            lastFromExpansion_ = true;
+            Token token = pending_[pendingIndex_++];
+            token.set_file(file_);
+            if (!includeStack_.empty()) trackIncludeGuard(includeStack_.back(), token);
+            return token;
+        }
+        lastFromExpansion_ = false;
+
+        if (skipping_) {
+            skipInactiveRegion();   // Lands on the next directive or at EOF
+        }
+
         skipWhitespaceAndComments();
 
         if (pos_ >= source_.size()) {
-            tokens.push_back(std::make_unique<Token>(TokenType::END_OF_FILE, "", line_, column_));
-            break;
+            if (leaveInclude()) {
+                continue;   // Back in the including file
+            }
+            beginToken();
+            return makeToken(TokenType::END_OF_FILE);
         }
 
         if (source_[pos_] == '#') {
-            auto directiveToken = lexPreprocessorDirective();
-            if (directiveToken) {
-                // Preprocessor directive token (rare case)
-                tokens.push_back(std::move(directiveToken));
+            // Preprocessor directive token (rare case). An #include pushes a
+            // frame, so note which file the directive itself belongs to.
+            size_t depth = includeStack_.size();
+            Token token;
+            if (!lexDirective(token)) {
+                continue;   // Inactive: stepped over without effect
             }
-            continue;
+            if (depth > 0) trackIncludeGuard(includeStack_[depth - 1], token);
+            return token;
         }
 
-        if (skipping_) {
-            // Skip tokens while skipping is active
-            // Skip until whitespace or newline to avoid infinite loop
-            while (pos_ < source_.size() && !isspace(source_[pos_])) {
-                advance();
+        Token token;
+        if (!takeSpeculative(token)) {
+            token = lexToken();
+        }
+
+        static const std::vector<std::string_view> kNoActiveMacros;
+        Macro* macro = findMacro(token, kNoActiveMacros);
+        if (macro && expandInvocation(token, *macro)) {
+            continue;   // Hand out the expansion (which may be empty)
+        }
+        if (!includeStack_.empty()) trackIncludeGuard(includeStack_.back(), token);
+        return token;
+    }
+}
+
+void Lexer::skipInactiveRegion() {
+    // Only a '#' that starts a line (after blanks or comments) can end the
+    // region. Lines are crossed with one SIMD scan each; the scan stops only
+    // for bytes that could hide a newline or a '#' from us: comments,
+    // quotes and backslash continuations.
+    const char* begin = source_.data();
+    const char* end = begin + source_.size();
+    const char* p = begin + pos_;
+    bool lineStart = pos_ == 0 || source_[pos_ - 1] == '\n';
+
+    while (p < end) {
+        if (lineStart) {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\f' || *p == '\v')) ++p;
+            if (p == end) break;
+            if (*p == '#') {
+                pos_ = p - begin;
+                return;
             }
-            continue;
+            if (p[0] == '/' && p + 1 < end && p[1] == '*') {
+                // A comment before the '#' still leaves it at the start of the line
+                const char* close = scan::findCommentEnd(p + 2, end);
+                p = close == end ? end : close + 2;
+                continue;
+            }
+            lineStart = false;
         }
 
-        auto token = lexToken();
-        if (token) {
-            if (token->type() == TokenType::IDENTIFIER) {
-                std::string expanded = expandMacro(token->text());
-                if (expanded != token->text()) {
-                    token = std::make_unique<Token>(TokenType::IDENTIFIER, expanded, token->line(), token->column());
-                }
+        const char* stop = scan::findSkipStop(p, end);
+        if (stop == end) break;
+        switch (*stop) {
+        case '\n':
+            p = stop + 1;
+            lineStart = true;
+            break;
+        case '\\':
+            if (size_t splice = scan::spliceLength(stop, end)) {
+                p = stop + splice;   // Escaped newline continues the line
+            } else {
+                p = stop + 2 <= end ? stop + 2 : end;
+            }
+            break;
+        case '/':
+            if (stop + 1 < end && stop[1] == '*') {
+                const char* close = scan::findCommentEnd(stop + 2, end);
+                p = close == end ? end : close + 2;
             }
-            tokens.push_back(std::move(token));
+            else if (stop + 1 < end && stop[1] == '/') {
+                p = scan::findNewline(stop + 2, end);
+            }
+            else {
+                p = stop + 1;
+            }
+            break;
+        default: {
+            // Quoted text; an unmatched quote (an apostrophe in prose) ends at the newline
+            const char* q = stop + 1;
+            while (true) {
+                q = scan::findLiteralStop(q, end, *stop);
+                if (q == end || *q != '\\') break;
+                size_t splice = scan::spliceLength(q, end);
+                q = splice ? q + splice : q + 2 <= end ? q + 2 : end;
+            }
+            p = (q < end && *q == *stop) ? q + 1 : q;
+            break;
+        }
         }
     }
-    return tokens;
+    pos_ = source_.size();
 }
 
 // === Basic helpers ===
@@ -69,14 +455,7 @@ char Lexer::peekNext() const {
 
 char Lexer::advance() {
     if (pos_ >= source_.size()) return '\0';
-    char c = source_[pos_++];
-    if (c == '\n') {
-        line_++;
-        column_ = 1;
-    } else {
-        column_++;
-    }
-    return c;
+    return source_[pos_++];
 }
 
 bool Lexer::match(char expected) {
@@ -87,21 +466,28 @@ bool Lexer::match(char expected) {
     return false;
 }
 
+void Lexer::advanceTo(size_t target) {
+    pos_ = target;
+}
+
 void Lexer::skipWhitespaceAndComments() {
-    while (true) {
-        char c = peek();
-        if (isspace(c)) {
-            advance();
+    const char* begin = source_.data();
+    const char* end = begin + source_.size();
+    while (pos_ < source_.size()) {
+        const char* p = begin + pos_;
+        if (charclass::isSpace(*p)) {
+            advanceTo(pos_ + scan::whitespaceRun(p, end));
         }
-        else if (c == '/' && peekNext() == '/') {
-            while (peek() != '\n' && peek() != '\0') advance();
+        else if (p[0] == '/' && p + 1 < end && p[1] == '/') {
+            // Line comment: stop at the newline, the whitespace branch consumes it
+            advanceTo(scan::findNewline(p + 2, end) - begin);
         }
-        else if (c == '/' && peekNext() == '*') {
-            advance(); advance();
-            while (!(peek() == '*' && peekNext() == '/') && peek() != '\0') advance();
-            if (peek() == '*' && peekNext() == '/') {
-                advance(); advance();
-            }
+        else if (p[0] == '/' && p + 1 < end && p[1] == '*') {
+            const char* close = scan::findCommentEnd(p + 2, end);
+            advanceTo(close == end ? source_.size() : (close + 2) - begin);
+        }
+        else if (size_t splice = scan::spliceLength(p, end)) {
+            advanceTo(pos_ + splice);   // Line splice
         }
         else {
             break;
@@ -109,15 +495,80 @@ void Lexer::skipWhitespaceAndComments() {
     }
 }
 
+void Lexer::skipLineSpace() {
+    const char* begin = source_.data();
+    const char* end = begin + source_.size();
+    while (pos_ < source_.size()) {
+        const char* p = begin + pos_;
+        if (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\f' || *p == '\v') {
+            advance();
+        }
+        else if (p[0] == '/' && p + 1 < end && p[1] == '*') {
+            const char* close = scan::findCommentEnd(p + 2, end);
+            advanceTo(close == end ? source_.size() : (close + 2) - begin);
+        }
+        else if (size_t splice = scan::spliceLength(p, end)) {
+            advanceTo(pos_ + splice);   // Line splice: the directive continues
+        }
+        else {
+            break;   // Including "//": readRestOfLine() keeps the comment, lexing drops it
+        }
+    }
+}
+
+std::string_view Lexer::readIdentifier() {
+    size_t start = pos_;
+    while (charclass::isIdentContinue(peek())) {
+        advance();
+    }
+    return source_.substr(start, pos_ - start);
+}
+
+std::string_view Lexer::readRestOfLine() {
+    size_t start = pos_;
+    const char* begin = source_.data();
+    const char* end = begin + source_.size();
+    while (true) {
+        const char* newline = scan::findNewline(begin + pos_, end);
+        advanceTo(newline - begin);
+        if (newline == end) break;
+        const char* last = newline;   // The '\\' of a splice sits before any '\r'
+        if (last > begin + start && last[-1] == '\r') --last;
+        if (last == begin + start || last[-1] != '\\') break;
+        advance();   // Spliced line: keep going
+    }
+    return source_.substr(start, pos_ - start);
+}
+
+// === Token creation helpers ===
+
+void Lexer::beginToken() {
+    tokenStartPos_ = pos_;
+}
+
+Token Lexer::makeToken(TokenType type) {
+    return makeToken(type, source_.substr(tokenStartPos_, pos_ - tokenStartPos_));
+}
+
+Token Lexer::makeToken(TokenType type, std::string_view text) {
+    Token token(type, text, static_cast<uint32_t>(tokenStartPos_));
+    token.set_file(file_);
+    return token;
+}
+
+Token Lexer::errorToken(std::string_view message) {
+    return makeToken(TokenType::ERROR, message);
+}
+
 // === Token lexers ===
 
-std::unique_ptr<Token> Lexer::lexToken() {
+Token Lexer::lexToken() {
     char c = peek();
 
-    if (isalpha(c) || c == '_') {
+    if (charclass::isIdentStart(c)) {
         return lexIdentifierOrKeyword();
     }
-    else if (isdigit(c)) {
+    else if (charclass::isDigit(c)) {
         return lexNumber();
     }
     else if (c == '"') {
@@ -127,726 +578,1155 @@ std::unique_ptr<Token> Lexer::lexToken() {
         return lexChar();
     }
 
-    advance(); // Consume the current character
+    beginToken();
+    PunctuatorMatch punctuator = matchPunctuator(source_.data() + pos_, source_.data() + source_.size());
+    if (punctuator.length == 0) {
+        advance();   // Not a punctuator: one byte becomes an ERROR token
+        return makeToken(TokenType::ERROR);
+    }
+    advanceTo(pos_ + punctuator.length);
+    return makeToken(punctuator.type);
+}
 
-    switch (c) {
-        case '+':
-            if (match('+')) return std::make_unique<Token>(TokenType::INCREMENT, "++", line_, column_ - 1);
-            if (match('=')) return std::make_unique<Token>(TokenType::PLUS_EQUAL, "+=", line_, column_ - 1);
-            return std::make_unique<Token>(TokenType::PLUS, "+", line_, column_ - 1);
+Token Lexer::lexIdentifierOrKeyword() {
+    beginToken();
+    std::string_view text = readIdentifier();
 
-        case '-':
-            if (match('-')) return std::make_unique<Token>(TokenType::DECREMENT, "--", line_, column_ - 1);
-            if (match('=')) return std::make_unique<Token>(TokenType::MINUS_EQUAL, "-=", line_, column_ - 1);
-            if (match('>')) return std::make_unique<Token>(TokenType::ARROW, "->", line_, column_ - 1);
-            return std::make_unique<Token>(TokenType::MINUS, "-", line_, column_ - 1);
+    Token token = makeToken(keywordLookup(text));
+    if (token.type() == TokenType::IDENTIFIER && internSymbols_) {
+        token.set_symbol(intern(text));
+    }
+    return token;
+}
 
-        case '=':
-            if (match('=')) return std::make_unique<Token>(TokenType::EQUAL_EQUAL, "==", line_, column_ - 1);
-            return std::make_unique<Token>(TokenType::EQUAL, "=", line_, column_ - 1);
+TokenType Lexer::keywordLookup(std::string_view identifier) const {
+    return lookupKeyword(identifier);
+}
 
-        case '!':
-            if (match('=')) return std::make_unique<Token>(TokenType::NOT_EQUAL, "!=", line_, column_ - 1);
-            return std::make_unique<Token>(TokenType::EXCLAIM, "!", line_, column_ - 1);
+Token Lexer::lexNumber() {
+    beginToken();
+    bool isFloat = false;
 
-        case '<':
-            if (match('=')) return std::make_unique<Token>(TokenType::LESS_EQUAL, "<=", line_, column_ - 1);
-            if (match('<')) {
-                if (match('=')) return std::make_unique<Token>(TokenType::LEFT_SHIFT_EQUAL, "<<=", line_, column_ - 2);
-                return std::make_unique<Token>(TokenType::LESS_LESS, "<<", line_, column_ - 1);
-            }
-            return std::make_unique<Token>(TokenType::LESS, "<", line_, column_ - 1);
+    // Hexadecimal: 0x1F is one literal, not 0 followed by the identifier x1F
+    if (peek() == '0' && (peekNext() == 'x' || peekNext() == 'X') &&
+        pos_ + 2 < source_.size() && charclass::isHexDigit(source_[pos_ + 2])) {
+        advance();
+        advance();
+        while (charclass::isHexDigit(peek())) {
+            advance();
+        }
+        return makeToken(TokenType::INTEGER);
+    }
 
-        case '>':
-            if (match('=')) return std::make_unique<Token>(TokenType::GREATER_EQUAL, ">=", line_, column_ - 1);
-            if (match('>')) {
-                if (match('=')) return std::make_unique<Token>(TokenType::RIGHT_SHIFT_EQUAL, ">>=", line_, column_ - 2);
-                return std::make_unique<Token>(TokenType::GREATER_GREATER, ">>", line_, column_ - 1);
-            }
-            return std::make_unique<Token>(TokenType::GREATER, ">", line_, column_ - 1);
+    while (charclass::isDigit(peek())) {
+        advance();
+    }
+    if (peek() == '.') {
+        isFloat = true;
+        advance();
+        while (charclass::isDigit(peek())) {
+            advance();
+        }
+    }
 
-        case '&':
-            if (match('&')) return std::make_unique<Token>(TokenType::AND_AND, "&&", line_, column_ - 1);
-            if (match('=')) return std::make_unique<Token>(TokenType::AND_EQUAL, "&=", line_, column_ - 1);
-            return std::make_unique<Token>(TokenType::AMPERSAND, "&", line_, column_ - 1);
+    // TODO: Support exponent notation if desired
 
-        case '|':
-            if (match('|')) return std::make_unique<Token>(TokenType::OR_OR, "||", line_, column_ - 1);
-            if (match('=')) return std::make_unique<Token>(TokenType::OR_EQUAL, "|=", line_, column_ - 1);
-            return std::make_unique<Token>(TokenType::PIPE, "|", line_, column_ - 1);
+    if (isFloat) {
+        return makeToken(TokenType::FLOAT);
+    }
+    return makeToken(TokenType::INTEGER);
+}
 
-        case '^':
-            if (match('=')) return std::make_unique<Token>(TokenType::XOR_EQUAL, "^=", line_, column_ - 1);
-            return std::make_unique<Token>(TokenType::CARET, "^", line_, column_ - 1);
+Token Lexer::lexString() {
+    return lexQuoted('"', TokenType::STRING_LITERAL, "Unterminated string literal");
+}
 
-        case '~':
-            return std::make_unique<Token>(TokenType::TILDE, "~", line_, column_ - 1);
+Token Lexer::lexChar() {
+    return lexQuoted('\'', TokenType::CHAR_LITERAL, "Unterminated char literal");
+}
 
-        case '*':
-            if (match('=')) return std::make_unique<Token>(TokenType::STAR_EQUAL, "*=", line_, column_ - 1);
-            return std::make_unique<Token>(TokenType::STAR, "*", line_, column_ - 1);
+Token Lexer::lexQuoted(char quote, TokenType type, std::string_view unterminatedMessage) {
+    beginToken();
+    advance(); // skip opening quote
+    size_t textStart = pos_;
+
+    // Hop between quote / backslash / newline bytes; the body is sliced from
+    // source_ as-is and escapes are decoded later only if someone asks.
+    const char* begin = source_.data();
+    const char* end = begin + source_.size();
+    const char* p = begin + pos_;
+    bool hasEscape = false;
+    while (true) {
+        p = scan::findLiteralStop(p, end, quote);
+        if (p == end || *p != '\\') break;
+        hasEscape = true;
+        size_t splice = scan::spliceLength(p, end);
+        p += splice ? splice : (end - p >= 2) ? 2 : 1;   // Skip the backslash and the escaped byte (or newline)
+    }
+    advanceTo(p - begin);
 
-        case '/':
-            if (match('=')) return std::make_unique<Token>(TokenType::SLASH_EQUAL, "/=", line_, column_ - 1);
-            return std::make_unique<Token>(TokenType::SLASH, "/", line_, column_ - 1);
+    if (p == end || *p == '\n') {
+        return errorToken(unterminatedMessage);
+    }
 
-        case '%':
-            if (match('=')) return std::make_unique<Token>(TokenType::PERCENT_EQUAL, "%=", line_, column_ - 1);
-            return std::make_unique<Token>(TokenType::PERCENT, "%", line_, column_ - 1);
+    std::string_view text = source_.substr(textStart, pos_ - textStart);
+    advance(); // skip closing quote
+    Token token = makeToken(type, text);
+    token.set_has_escape(hasEscape);
+    return token;
+}
 
-        case '?':
-            return std::make_unique<Token>(TokenType::QUESTION, "?", line_, column_ - 1);
-
-        case ':':
-            if (match(':')) return std::make_unique<Token>(TokenType::SCOPE, "::", line_, column_ - 1);
-            return std::make_unique<Token>(TokenType::COLON, ":", line_, column_ - 1);
-
-        case ';':
-            return std::make_unique<Token>(TokenType::SEMICOLON, ";", line_, column_ - 1);
-
-        case ',':
-            return std::make_unique<Token>(TokenType::COMMA, ",", line_, column_ - 1);
-
-        case '.':
-            return std::make_unique<Token>(TokenType::DOT, ".", line_, column_ - 1);
-
-        case '(':
-            return std::make_unique<Token>(TokenType::LEFT_PAREN, "(", line_, column_ - 1);
-
-        case ')':
-            return std::make_unique<Token>(TokenType::RIGHT_PAREN, ")", line_, column_ - 1);
-
-        case '{':
-            return std::make_unique<Token>(TokenType::LEFT_BRACE, "{", line_, column_ - 1);
-
-        case '}':
-            return std::make_unique<Token>(TokenType::RIGHT_BRACE, "}", line_, column_ - 1);
-
-        case '[':
-            return std::make_unique<Token>(TokenType::LEFT_BRACKET, "[", line_, column_ - 1);
-
-        case ']':
-            return std::make_unique<Token>(TokenType::RIGHT_BRACKET, "]", line_, column_ - 1);
-
-        case '#':
-            return std::make_unique<Token>(TokenType::HASH, "#", line_, column_ - 1);
-
-        default:
-            return std::make_unique<Token>(TokenType::ERROR, std::string(1, c), line_, column_ - 1);
-    }
-
-    return std::make_unique<Token>(TokenType::ERROR, std::string(1, c), line_, column_ - 1);
-}
-
-std::unique_ptr<Token> Lexer::lexIdentifierOrKeyword() {
-    int startLine = line_;
-    int startCol = column_;
-    std::string text;
-    while (isalnum(peek()) || peek() == '_') {
-        text.push_back(advance());
-    }
-
-    static const std::unordered_map<std::string, TokenType> keywords = {
-    // C++ keywords
-    {"int", TokenType::INT}, {"void", TokenType::VOID}, {"char", TokenType::CHAR},
-    {"float", TokenType::FLOAT_TYPE}, {"double", TokenType::DOUBLE}, {"bool", TokenType::BOOL},
-    {"class", TokenType::CLASS}, {"struct", TokenType::STRUCT}, {"enum", TokenType::ENUM},
-    {"union", TokenType::UNION}, {"const", TokenType::CONST}, {"unsigned", TokenType::UNSIGNED},
-    {"signed", TokenType::SIGNED}, {"short", TokenType::SHORT}, {"long", TokenType::LONG},
-    {"static", TokenType::STATIC}, {"extern", TokenType::EXTERN}, {"register", TokenType::REGISTER},
-    {"inline", TokenType::INLINE}, {"virtual", TokenType::VIRTUAL}, {"explicit", TokenType::EXPLICIT},
-    {"friend", TokenType::FRIEND}, {"private", TokenType::PRIVATE}, {"public", TokenType::PUBLIC},
-    {"protected", TokenType::PROTECTED}, {"if", TokenType::IF}, {"else", TokenType::ELSE},
-    {"for", TokenType::FOR}, {"while", TokenType::WHILE}, {"do", TokenType::DO},
-    {"switch", TokenType::SWITCH}, {"case", TokenType::CASE}, {"default", TokenType::DEFAULT},
-    {"break", TokenType::BREAK}, {"continue", TokenType::CONTINUE}, {"return", TokenType::RETURN},
-    {"goto", TokenType::GOTO}, {"namespace", TokenType::NAMESPACE}, {"using", TokenType::USING},
-    {"template", TokenType::TEMPLATE},{"typedef", TokenType::TYPEDEF},
-
-    // STL Containers
-    {"vector", TokenType::VECTOR}, {"map", TokenType::MAP}, {"set", TokenType::SET},
-    {"list", TokenType::LIST}, {"deque", TokenType::DEQUE}, {"unordered_map", TokenType::UNORDERED_MAP},
-    {"unordered_set", TokenType::UNORDERED_SET}, {"multimap", TokenType::MULTIMAP},
-    {"multiset", TokenType::MULTISET}, {"stack", TokenType::STACK}, {"queue", TokenType::QUEUE},
-    {"priority_queue", TokenType::PRIORITY_QUEUE}, {"bitset", TokenType::BITSET},
-    {"array", TokenType::ARRAY}, {"forward_list", TokenType::FORWARD_LIST},
-    {"pair", TokenType::PAIR}, {"tuple", TokenType::TUPLE}, {"string", TokenType::STRING_LIB},
-    {"optional", TokenType::OPTIONAL}, {"variant", TokenType::VARIANT}, {"any", TokenType::ANY},
-    {"span", TokenType::SPAN}, {"valarray", TokenType::VALARRAY},
-
-    // C standard lib functions
-    {"printf", TokenType::PRINTF}, {"scanf", TokenType::SCANF}, {"malloc", TokenType::MALLOC},
-    {"free", TokenType::FREE}, {"memcpy", TokenType::MEMCPY}, {"strcpy", TokenType::STRCPY},
-    {"strlen", TokenType::STRLEN},
-
-    // C++ I/O Streams
-    {"cin", TokenType::CIN}, {"cout", TokenType::COUT}, {"cerr", TokenType::CERR}, {"clog", TokenType::CLIN},
-
-    // Algorithms (add as needed)
-    {"sort", TokenType::SORT}, {"find", TokenType::FIND}, {"count", TokenType::COUNT}, {"copy", TokenType::COPY},
-    {"reverse", TokenType::REVERSE}, {"accumulate", TokenType::ACCUMULATE},
-    {"all_of", TokenType::ALL_OF}, {"any_of", TokenType::ANY_OF}, {"none_of", TokenType::NONE_OF},
-    {"lower_bound", TokenType::LOWER_BOUND}, {"upper_bound", TokenType::UPPER_BOUND},
-
-    // Math (add as needed)
-    {"abs", TokenType::ABS}, {"fabs", TokenType::FABS}, {"pow", TokenType::POW}, {"sqrt", TokenType::SQRT},
-    {"sin", TokenType::SIN}, {"cos", TokenType::COS}, {"tan", TokenType::TAN},
-    {"floor", TokenType::FLOOR}, {"ceil", TokenType::CEIL}, {"round", TokenType::ROUND},
-    {"rand", TokenType::RAND}, {"srand", TokenType::SRAND}, {"exit", TokenType::EXIT},
-
-    // Strings (add as needed)
-    {"stoi", TokenType::STOI}, {"stof", TokenType::STOF}, {"stod", TokenType::STOD}, {"to_string", TokenType::TO_STRING},
-    {"strcmp", TokenType::STRCMP}, {"strncmp", TokenType::STRNCMP}, {"strchr", TokenType::STRCHR},
-    {"strrchr", TokenType::STRRCHR}, {"strstr", TokenType::STRSTR}, {"strcat", TokenType::STRCAT},
-    {"strncat", TokenType::STRNCAT},
-
-    // Memory and allocation (add as needed)
-    {"new", TokenType::NEW}, {"delete", TokenType::DELETE}, {"allocate", TokenType::ALLOCATE}, {"deallocate", TokenType::DEALLOCATE},
-
-    // Time (add as needed)
-    {"time", TokenType::TIME}, {"clock", TokenType::CLOCK}, {"difftime", TokenType::DIFFTIME},
-    {"strftime", TokenType::STRFTIME}, {"localtime", TokenType::LOCALTIME}, {"gmtime", TokenType::GMTIME},
-
-    // Concurrency (add as needed)
-    {"thread", TokenType::THREAD}, {"mutex", TokenType::MUTEX}, {"lock_guard", TokenType::LOCK_GUARD},
-    {"unique_lock", TokenType::UNIQUE_LOCK}, {"async", TokenType::ASYNC}, {"future", TokenType::FUTURE},
-    {"promise", TokenType::PROMISE},
-
-    // Exceptions (add as needed)
-    {"try", TokenType::TRY}, {"catch", TokenType::CATCH}, {"throw", TokenType::THROW},
-    {"exception", TokenType::EXCEPTION}, {"logic_error", TokenType::LOGIC_ERROR}, {"runtime_error", TokenType::RUNTIME_ERROR},
-
-    // RTTI / Casting (add as needed)
-    {"typeid", TokenType::TYPEID}, {"static_cast", TokenType::STATIC_CAST}, {"dynamic_cast", TokenType::DYNAMIC_CAST},
-    {"const_cast", TokenType::CONST_CAST}, {"reinterpret_cast", TokenType::REINTERPRET_CAST}
-};
+// === Macro system ===
+//
+// Replacement lists are lexed once, at #define time. Expanding a use
+// substitutes arguments (with # and ##), then rescans the result with the
+// macro itself disabled, which is what stops recursion; a name met while
+// its macro is disabled is marked no_expand for good. A function-like name
+// that ends an object-like expansion is rescanned together with what
+// follows the use, so it can still find its arguments there. Tokens
+// produced by an expansion all carry the offset of the use. Object-like
+// macros keep their top-level expansion and reuse it until the next
+// #define/#undef.
+
+namespace {
+
+bool isIdentifierLike(const Token& token) {
+    std::string_view text = token.view();
+    return !text.empty() && charclass::isIdentStart(text[0]) &&
+           token.type() != TokenType::STRING_LITERAL &&
+           token.type() != TokenType::CHAR_LITERAL &&
+           token.type() != TokenType::ERROR;
+}
+
+// Quote written around the token's text in source ("" for non-literals)
+std::string_view quoteOf(const Token& token) {
+    if (token.type() == TokenType::STRING_LITERAL) return "\"";
+    if (token.type() == TokenType::CHAR_LITERAL) return "'";
+    return {};
+}
 
-    auto it = keywords.find(text);
-    if (it != keywords.end()) {
-        return std::make_unique<Token>(it->second, text, startLine, startCol);
+size_t spellingLength(const Token& token) {
+    bool quoted = token.type() == TokenType::STRING_LITERAL || token.type() == TokenType::CHAR_LITERAL;
+    return token.view().size() + (quoted ? 2 : 0);
+}
+
+// "##" in a replacement list: two '#' tokens with nothing in between
+bool isPasteAt(const std::vector<Token>& body, size_t i) {
+    return i + 1 < body.size() &&
+           body[i].type() == TokenType::HASH && body[i + 1].type() == TokenType::HASH &&
+           body[i + 1].offset() == body[i].offset() + 1;
+}
+
+int paramIndex(const std::vector<std::string_view>& params, const Token& token) {
+    if (!isIdentifierLike(token)) return -1;
+    for (size_t i = 0; i < params.size(); ++i) {
+        if (params[i] == token.view()) return static_cast<int>(i);
     }
-    return std::make_unique<Token>(TokenType::IDENTIFIER, text, startLine, startCol);
+    return -1;
 }
 
-std::unique_ptr<Token> Lexer::lexNumber() {
-    int startLine = line_;
-    int startCol = column_;
-    std::string text;
-    bool isFloat = false;
+Token atOffset(const Token& token, uint32_t offset) {
+    return token.relocated(token.view().data(), offset);
+}
 
-    while (isdigit(peek())) {
-        text.push_back(advance());
+} // unnamed namespace
+
+void Lexer::defineMacro(std::string_view name, Macro macro) {
+    if (macros_.insert_or_assign(name, std::move(macro)).second) {
+        macroFilter_.add(name);
     }
-    if (peek() == '.') {
-        isFloat = true;
-        text.push_back(advance());
-        while (isdigit(peek())) {
-            text.push_back(advance());
+    macroGeneration_++;
+}
+
+void Lexer::undefineMacro(std::string_view name) {
+    if (macros_.erase(name) != 0) {
+        macroFilter_.remove(name);
+    }
+    macroGeneration_++;
+}
+
+bool Lexer::isMacroDefined(std::string_view name) const {
+    if (!macroFilter_.mayContain(name)) return false;
+    return macros_.find(name) != macros_.end();
+}
+
+uint64_t Lexer::macroFingerprint() const {
+    std::vector<std::pair<std::string_view, std::string_view>> sorted;
+    sorted.reserve(macros_.size());
+    for (const auto& [name, macro] : macros_) {
+        sorted.emplace_back(name, macro.definition);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    uint64_t h = 14695981039346656037ull;   // FNV-1a over "name\0definition\0"...
+    auto mix = [&h](std::string_view text) {
+        for (char c : text) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
         }
+        h *= 1099511628211ull;   // The terminating '\0' (xor with 0 is a no-op)
+    };
+    for (const auto& [name, definition] : sorted) {
+        mix(name);
+        mix(definition);
     }
+    return h;
+}
 
-    // TODO: Support exponent notation if desired
+Token Lexer::lexRaw() {
+    skipWhitespaceAndComments();
+    if (pos_ >= source_.size()) {
+        beginToken();
+        return makeToken(TokenType::END_OF_FILE);
+    }
+    return lexToken();
+}
 
-    if (isFloat) {
-        return std::make_unique<Token>(TokenType::FLOAT, text, startLine, startCol);
+std::vector<Token> Lexer::lexMacroBody(std::string_view text, size_t offset) {
+    std::vector<Token> body;
+    Lexer sub(text);
+    while (true) {
+        sub.skipWhitespaceAndComments();
+        if (sub.pos_ >= text.size()) break;
+        Token token = sub.lexToken();
+        body.push_back(token.relocated(token.view().data(),
+                                       static_cast<uint32_t>(offset + token.offset())));
+    }
+    return body;
+}
+
+Lexer::Macro* Lexer::findMacro(Token& token, const std::vector<std::string_view>& active) {
+    if (macros_.empty() || token.no_expand() || !isIdentifierLike(token)) return nullptr;
+    macroStats_.lookups++;
+    if (!macroFilter_.mayContain(token.view())) {
+        macroStats_.filtered++;
+        return nullptr;
+    }
+    auto it = macros_.find(token.view());
+    if (it == macros_.end()) {
+        macroStats_.falsePositives++;
+        return nullptr;
+    }
+    if (std::find(active.begin(), active.end(), it->first) != active.end()) {
+        token.set_no_expand(true);   // Already being expanded: the name stands for itself
+        return nullptr;
+    }
+    return &it->second;
+}
+
+bool Lexer::expandInvocation(const Token& name, Macro& macro) {
+    // pending_ has been drained, so its capacity is reused for this expansion
+    std::vector<Token>& expansion = pending_;
+    std::vector<std::string_view>& active = activeMacros_;
+    expansion.clear();
+    active.clear();
+    if (!macro.functionLike) {
+        expandObject(name.view(), macro, expansion, active, name.offset());
+        TokenCursor cursor{nullptr, 0, true};
+        expandTrailingCall(0, cursor, expansion, active, name.offset());
     }
-    return std::make_unique<Token>(TokenType::INTEGER, text, startLine, startCol);
+    else {
+        TokenCursor cursor{nullptr, 0, true};
+        if (!openParenFollows(cursor)) {
+            return false;   // Just the name, not a call
+        }
+        std::vector<std::vector<Token>> args;
+        std::vector<Token> consumed;
+        if (!collectArguments(cursor, macro, args, consumed)) {
+            // Unterminated call: give back what was read, unexpanded
+            expansion.push_back(name);
+            expansion.insert(expansion.end(), consumed.begin(), consumed.end());
+        }
+        else {
+            expandFunction(name.view(), macro, args, true, expansion, active, name.offset());
+        }
+    }
+    pendingIndex_ = 0;
+    return true;
 }
 
-std::unique_ptr<Token> Lexer::lexString() {
-    int startLine = line_;
-    int startCol = column_;
-    std::string text;
-    advance(); // skip opening "
+void Lexer::expandList(const std::vector<Token>& in, bool sourceTail, std::vector<Token>& out,
+                       std::vector<std::string_view>& active, uint32_t offset) {
+    for (size_t i = 0; i < in.size(); ++i) {
+        Token token = atOffset(in[i], offset);
+        Macro* macro = findMacro(token, active);
+        if (!macro) {
+            out.push_back(token);
+            continue;
+        }
 
-    while (peek() != '"' && peek() != '\0') {
-        if (peek() == '\\') {
-            text.push_back(advance());
-            if (peek() != '\0') text.push_back(advance());
+        TokenCursor cursor{&in, i + 1, sourceTail};
+        bool complete;
+        if (!macro->functionLike) {
+            size_t from = out.size();
+            expandObject(token.view(), *macro, out, active, offset);
+            complete = expandTrailingCall(from, cursor, out, active, offset);
         }
         else {
-            text.push_back(advance());
+            complete = expandCall(token, *macro, cursor, out, active, offset);
         }
+        if (!complete) break;   // An unterminated call took the rest of the list
+        i = std::min(cursor.index, in.size()) - 1;
     }
+}
 
-    if (peek() == '"') {
-        advance(); // skip closing "
-        return std::make_unique<Token>(TokenType::STRING_LITERAL, text, startLine, startCol);
+// A use of a function-like macro: expanded if '(' follows through cursor,
+// else the bare name. Returns false if the call runs out unterminated, in
+// which case the tokens read are given back unexpanded.
+bool Lexer::expandCall(const Token& name, const Macro& macro, TokenCursor& cursor, std::vector<Token>& out,
+                       std::vector<std::string_view>& active, uint32_t offset) {
+    if (!openParenFollows(cursor)) {
+        out.push_back(atOffset(name, offset));
+        return true;
     }
-    else {
-        // Unterminated string literal error
-        return std::make_unique<Token>(TokenType::ERROR, "Unterminated string literal", startLine, startCol);
+    std::vector<std::vector<Token>> args;
+    std::vector<Token> consumed;
+    if (!collectArguments(cursor, macro, args, consumed)) {
+        out.push_back(atOffset(name, offset));
+        for (const Token& t : consumed) out.push_back(atOffset(t, offset));
+        return false;
     }
+    bool reachedSource = !cursor.list || cursor.index > cursor.list->size();
+    expandFunction(name.view(), macro, args, cursor.fromSource && reachedSource, out, active, offset);
+    return true;
 }
 
-std::unique_ptr<Token> Lexer::lexChar() {
-    int startLine = line_;
-    int startCol = column_;
-    std::string text;
-    advance(); // skip opening '
+// out[from..] is an object-like expansion just appended. If it ends in the
+// name of a function-like macro, that name's arguments may follow the use
+// (#define F f, then F(2)), so it is taken back and expanded as a call
+// reading through cursor. Same return value as expandCall().
+bool Lexer::expandTrailingCall(size_t from, TokenCursor& cursor, std::vector<Token>& out,
+                               std::vector<std::string_view>& active, uint32_t offset) {
+    if (out.size() == from) return true;   // Empty expansion: nothing of it can be called
+    Macro* macro = findMacro(out.back(), active);
+    if (!macro || !macro->functionLike) return true;
+    Token name = out.back();
+    out.pop_back();
+    return expandCall(name, *macro, cursor, out, active, offset);
+}
 
-    if (peek() == '\\') {
-        text.push_back(advance());
-        if (peek() != '\0') text.push_back(advance());
+void Lexer::expandObject(std::string_view name, Macro& macro, std::vector<Token>& out,
+                         std::vector<std::string_view>& active, uint32_t offset) {
+    bool topLevel = active.empty();
+    if (topLevel && macro.expansionGeneration == macroGeneration_) {
+        for (const Token& token : macro.expansion) out.push_back(atOffset(token, offset));
+        return;
     }
-    else {
-        text.push_back(advance());
+
+    std::vector<Token> expansion;
+    active.push_back(name);
+    expandList(macro.body, false, expansion, active, offset);
+    active.pop_back();
+
+    if (topLevel) {
+        // Nothing outside this macro affected the result, so it can be reused
+        macro.expansion = expansion;
+        macro.expansionGeneration = macroGeneration_;
     }
+    out.insert(out.end(), expansion.begin(), expansion.end());
+}
+
+void Lexer::expandFunction(std::string_view name, const Macro& macro,
+                           const std::vector<std::vector<Token>>& args, bool sourceTail,
+                           std::vector<Token>& out, std::vector<std::string_view>& active, uint32_t offset) {
+    // Arguments are macro-expanded before substitution, except next to # or ##
+    std::vector<std::vector<Token>> expandedArgs(args.size());
+    std::vector<bool> expanded(args.size(), false);
+    auto expandedArg = [&](size_t index) -> const std::vector<Token>& {
+        if (!expanded[index]) {
+            expandList(args[index], false, expandedArgs[index], active, offset);
+            expanded[index] = true;
+        }
+        return expandedArgs[index];
+    };
+
+    const std::vector<Token>& body = macro.body;
+    std::vector<Token> result;
+    bool leftIsEmptyArg = false;   // Placemarker: the operand before ## was an empty argument
+    for (size_t i = 0; i < body.size(); ++i) {
+        if (isPasteAt(body, i) && i + 2 < body.size()) {
+            const Token& operand = body[i + 2];
+            int param = paramIndex(macro.params, operand);
+            std::vector<Token> right = param >= 0 ? args[param] : std::vector<Token>{operand};
+            i += 2;
+
+            if (leftIsEmptyArg || result.empty()) {
+                for (const Token& t : right) result.push_back(atOffset(t, offset));
+            }
+            else if (!right.empty()) {
+                Token joined;
+                if (paste(result.back(), right.front(), offset, joined)) {
+                    result.back() = joined;
+                }
+                else {
+                    result.push_back(atOffset(right.front(), offset));   // Not a valid token: keep both
+                }
+                for (size_t k = 1; k < right.size(); ++k) result.push_back(atOffset(right[k], offset));
+            }
+            leftIsEmptyArg = leftIsEmptyArg && right.empty();
+            continue;
+        }
 
-    if (peek() == '\'') {
-        advance(); // skip closing '
-        return std::make_unique<Token>(TokenType::CHAR_LITERAL, text, startLine, startCol);
+        const Token& token = body[i];
+        leftIsEmptyArg = false;
+
+        if (token.type() == TokenType::HASH && i + 1 < body.size() && !isPasteAt(body, i)) {
+            int param = paramIndex(macro.params, body[i + 1]);
+            if (param >= 0) {
+                result.push_back(stringize(args[param], offset));
+                i++;
+                continue;
+            }
+        }
+
+        int param = paramIndex(macro.params, token);
+        if (param < 0) {
+            result.push_back(atOffset(token, offset));
+        }
+        else if (isPasteAt(body, i + 1)) {
+            for (const Token& t : args[param]) result.push_back(atOffset(t, offset));
+            leftIsEmptyArg = args[param].empty();
+        }
+        else {
+            const std::vector<Token>& value = expandedArg(param);
+            result.insert(result.end(), value.begin(), value.end());
+        }
     }
-    else {
-        return std::make_unique<Token>(TokenType::ERROR, "Unterminated char literal", startLine, startCol);
+
+    active.push_back(name);
+    expandList(result, sourceTail, out, active, offset);
+    active.pop_back();
+}
+
+bool Lexer::nextCursorToken(TokenCursor& cursor, Token& token) {
+    if (cursor.list && cursor.index < cursor.list->size()) {
+        token = (*cursor.list)[cursor.index++];
+        return true;
     }
+    if (!cursor.fromSource) return false;
+    token = lexRaw();
+    if (cursor.list) cursor.index = cursor.list->size() + 1;   // Past the list, into the source
+    return token.type() != TokenType::END_OF_FILE;
 }
 
-// === Macro system ===
+bool Lexer::openParenFollows(TokenCursor& cursor) {
+    if (cursor.list && cursor.index < cursor.list->size()) {
+        if ((*cursor.list)[cursor.index].type() != TokenType::LEFT_PAREN) return false;
+        cursor.index++;
+        return true;
+    }
+    if (!cursor.fromSource) return false;
 
-void Lexer::defineMacro(const std::string& name, const std::string& value) {
-    macros_[name] = value;
+    size_t saved = pos_;
+    skipWhitespaceAndComments();
+    if (pos_ < source_.size() && source_[pos_] == '(') {
+        advance();
+        if (cursor.list) cursor.index = cursor.list->size() + 1;
+        return true;
+    }
+    pos_ = saved;
+    return false;
 }
 
-bool Lexer::isMacroDefined(const std::string& name) const {
-    return macros_.find(name) != macros_.end();
+bool Lexer::collectArguments(TokenCursor& cursor, const Macro& macro,
+                             std::vector<std::vector<Token>>& args, std::vector<Token>& consumed) {
+    args.emplace_back();
+    int depth = 0;
+    Token token;
+    while (true) {
+        if (!nextCursorToken(cursor, token)) return false;
+        consumed.push_back(token);
+
+        TokenType type = token.type();
+        if (type == TokenType::RIGHT_PAREN && depth == 0) break;
+        if (type == TokenType::LEFT_PAREN) depth++;
+        if (type == TokenType::RIGHT_PAREN) depth--;
+
+        // The variadic parameter swallows the remaining commas
+        bool inVarArgs = macro.variadic && args.size() == macro.params.size();
+        if (type == TokenType::COMMA && depth == 0 && !inVarArgs) {
+            args.emplace_back();
+            continue;
+        }
+        args.back().push_back(token);
+    }
+
+    if (macro.params.empty() && args.size() == 1 && args[0].empty()) {
+        args.clear();   // F() for a macro with no parameters
+    }
+    args.resize(std::max(args.size(), macro.params.size()));   // Missing arguments are empty
+    return true;
+}
+
+Token Lexer::stringize(const std::vector<Token>& arg, uint32_t offset) {
+    std::string& text = scratch_;   // Reused across calls; only the final text is kept
+    text.clear();
+    for (size_t i = 0; i < arg.size(); ++i) {
+        // One space wherever the argument had whitespace between tokens
+        if (i > 0 && arg[i].offset() != arg[i - 1].offset() + spellingLength(arg[i - 1])) {
+            text += ' ';
+        }
+        std::string_view quote = quoteOf(arg[i]);
+        for (std::string_view piece : {quote, arg[i].view(), quote}) {
+            for (char c : piece) {
+                if (!quote.empty() && (c == '"' || c == '\\')) text += '\\';
+                text += c;
+            }
+        }
+    }
+    bool hasEscape = text.find('\\') != std::string::npos;
+    Token token(TokenType::STRING_LITERAL, textArena_.copy(text), offset);
+    token.set_has_escape(hasEscape);
+    return token;
+}
+
+bool Lexer::paste(const Token& left, const Token& right, uint32_t offset, Token& result) {
+    std::string_view text = textArena_.concat({quoteOf(left), left.view(), quoteOf(left),
+                                               quoteOf(right), right.view(), quoteOf(right)});
+    Lexer sub(text);
+    Token token = sub.lexToken();
+    if (sub.pos_ != text.size() || token.type() == TokenType::ERROR) {
+        return false;
+    }
+    result = atOffset(token, offset);
+    return true;
+}
+
+// === #include ===
+
+void Lexer::setIncludeResolver(IncludeResolver* resolver, std::string mainPath) {
+    includes_ = resolver;
+    mainPath_ = std::move(mainPath);
 }
 
-std::string Lexer::expandMacro(const std::string& text) const {
-    auto it = macros_.find(text);
-    if (it != macros_.end()) {
-        return it->second;
+const LineIndex& Lexer::lineIndexFor(uint16_t file) const {
+    if (file != 0 && includes_) {
+        if (const SourceFile* header = includes_->file(file)) return header->lines;
+    }
+    return lineIndex_;
+}
+
+std::string_view Lexer::fileName(uint16_t file) const {
+    if (file != 0 && includes_) {
+        if (const SourceFile* header = includes_->file(file)) return header->path;
+    }
+    return mainPath_;
+}
+
+void Lexer::enterInclude(std::string_view name, bool angled) {
+    std::string_view includerPath = file_ == 0 ? std::string_view(mainPath_)
+                                               : std::string_view(includes_->file(file_)->path);
+    SourceFile* header = includes_->resolve(name, angled, includerPath);
+    if (!header) {
+        // Angled names are usually system headers, which are left to the Java side
+        if (!angled) {
+            std::cerr << "Cannot open include file \"" << name << "\" at line "
+                      << lineIndexFor(file_).lineOf(tokenStartPos_) << std::endl;
+        }
+        return;
+    }
+
+    // Multiple-include optimization: nothing to read if the guard already holds
+    if (entered_.size() <= header->id) entered_.resize(header->id + 1, false);
+    if (header->pragmaOnce && entered_[header->id]) return;
+    if (!header->guard.empty() && isMacroDefined(header->guard)) return;
+
+    if (includeStack_.size() >= kMaxIncludeDepth) {
+        std::cerr << "#include nested too deeply at \"" << name << "\"" << std::endl;
+        return;
+    }
+
+    entered_[header->id] = true;
+    includeStack_.push_back(IncludeFrame{source_, pos_, file_, conditionalStack_.size(), header,
+                                         IncludeFrame::Guard::Start, {}, 0});
+    source_ = header->buffer.view();
+    pos_ = 0;
+    file_ = header->id;
+}
+
+bool Lexer::leaveInclude() {
+    if (includeStack_.empty()) return false;
+
+    IncludeFrame& frame = includeStack_.back();
+    if (frame.guard == IncludeFrame::Guard::Closed) {
+        frame.header->guard = frame.guardMacro;
+    }
+    // Conditionals do not span files: an #if left open ends with the header
+    if (conditionalStack_.size() > frame.conditionalDepth) {
+        std::cerr << "Unterminated conditional in " << frame.header->path << std::endl;
+        conditionalStack_.resize(frame.conditionalDepth);
+    }
+    skipping_ = !conditionalStack_.back().active;
+
+    source_ = frame.source;
+    pos_ = frame.pos;
+    file_ = frame.file;
+    includeStack_.pop_back();
+    return true;
+}
+
+// A header is guarded when its first token is "#ifndef NAME" and the
+// matching #endif (with no #else/#elif) is its last. Once that is seen, a
+// later #include with NAME defined would produce nothing, so it is skipped.
+void Lexer::trackIncludeGuard(IncludeFrame& frame, const Token& token) {
+    using Guard = IncludeFrame::Guard;
+    switch (frame.guard) {
+    case Guard::Start:
+        if (token.type() == TokenType::PREPROCESSOR_IFNDEF) {
+            frame.guard = Guard::Open;
+            frame.guardMacro = token.view();
+            frame.guardDepth = conditionalStack_.size();
+        } else {
+            frame.guard = Guard::None;
+        }
+        break;
+    case Guard::Open:
+        if (conditionalStack_.size() < frame.guardDepth) {
+            frame.guard = Guard::Closed;
+        } else if (conditionalStack_.size() == frame.guardDepth &&
+                   (token.type() == TokenType::PREPROCESSOR_ELSE || token.type() == TokenType::PREPROCESSOR_ELIF)) {
+            frame.guard = Guard::None;
+        }
+        break;
+    case Guard::Closed:
+        frame.guard = Guard::None;   // Something follows the guard's #endif
+        break;
+    case Guard::None:
+        break;
     }
-    return text;
 }
 
 // === Preprocessor directives ===
 
-std::unique_ptr<Token> Lexer::lexPreprocessorDirective() {
+bool Lexer::lexDirective(Token& token) {
+    bool inactive = skipping_;
+    token = lexPreprocessorDirective();
+    return !(inactive && token.type() == TokenType::PREPROCESSOR_UNKNOWN);
+}
+
+Token Lexer::lexPreprocessorDirective() {
     // At start: pos_ points to '#'
-    int startLine = line_;
-    int startCol = column_;
+    beginToken();
     advance(); // consume '#'
 
-    skipWhitespaceAndComments();
+    skipLineSpace();
 
     // Read directive keyword
-    std::string directive;
-    while (isalnum(peek()) || peek() == '_') {
-        directive.push_back(advance());
+    std::string_view directive = readIdentifier();
+
+    // In a skipped region only the conditionals matter; anything else is
+    // consumed without effect and its token dropped by lexNext()
+    if (skipping_ && !isConditionalDirective(directive)) {
+        readRestOfLine();
+        return makeToken(TokenType::PREPROCESSOR_UNKNOWN, "");
     }
 
     if (directive == "define") {
-        skipWhitespaceAndComments();
+        skipLineSpace();
         // Read macro name
-        std::string macroName;
-        while (isalnum(peek()) || peek() == '_') {
-            macroName.push_back(advance());
+        std::string_view macroName = readIdentifier();
+        size_t definitionStart = pos_;
+        Macro macro;
+
+        // A '(' straight after the name (no space) makes it function-like
+        if (peek() == '(') {
+            macro.functionLike = true;
+            advance();
+            while (true) {
+                skipLineSpace();
+                if (peek() == ')') {
+                    advance();
+                    break;
+                }
+                if (peek() == '.' && peekNext() == '.') {
+                    advanceTo(std::min(pos_ + 3, source_.size()));
+                    macro.variadic = true;
+                    macro.params.push_back("__VA_ARGS__");
+                    continue;
+                }
+                std::string_view param = readIdentifier();
+                if (param.empty()) break;   // Malformed parameter list
+                macro.params.push_back(param);
+                skipLineSpace();
+                match(',');
+            }
         }
-        skipWhitespaceAndComments();
+
+        skipLineSpace();
         // Read macro replacement text (until newline)
-        std::string macroValue;
-        while (peek() != '\n' && peek() != '\0') {
-            macroValue.push_back(advance());
+        size_t valueStart = pos_;
+        std::string_view macroValue = readRestOfLine();
+        macro.definition = source_.substr(definitionStart, pos_ - definitionStart);
+        macro.body = lexMacroBody(macroValue, valueStart);
+        defineMacro(macroName, std::move(macro));
+
+        std::string_view params = source_.substr(definitionStart, valueStart - definitionStart);
+        while (!params.empty() && charclass::isSpace(params.back())) params.remove_suffix(1);
+        std::string_view paramsGap = params.empty() ? "" : " ";
+        return makeToken(TokenType::PREPROCESSOR_DEFINE,
+                         textArena_.concat({macroName, paramsGap, params, " ", macroValue}));
+    }
+    else if (directive == "include") {
+        skipLineSpace();
+        std::string_view rest = readRestOfLine();
+        // "name" or <name>; anything after the closing delimiter is ignored
+        char close = rest.empty() ? '\0' : rest[0] == '<' ? '>' : rest[0] == '"' ? '"' : '\0';
+        size_t closeAt = close ? rest.find(close, 1) : std::string_view::npos;
+        if (closeAt == std::string_view::npos) {
+            // Malformed, or a macro naming the header: not followed
+            return makeToken(TokenType::PREPROCESSOR_INCLUDE, rest);
         }
-        defineMacro(macroName, macroValue);
-        return std::make_unique<Token>(TokenType::PREPROCESSOR_DEFINE, macroName + " " + macroValue, startLine, startCol);
+        Token token = makeToken(TokenType::PREPROCESSOR_INCLUDE, rest.substr(0, closeAt + 1));
+        if (includes_) {
+            enterInclude(rest.substr(1, closeAt - 1), close == '>');
+        }
+        return token;
     }
     else if (directive == "undef") {
-        skipWhitespaceAndComments();
-        std::string macroName;
-        while (isalnum(peek()) || peek() == '_') {
-            macroName.push_back(advance());
-        }
-        macros_.erase(macroName);
-        return std::make_unique<Token>(TokenType::PREPROCESSOR_UNDEF, macroName, startLine, startCol);
+        skipLineSpace();
+        std::string_view macroName = readIdentifier();
+        undefineMacro(macroName);
+        return makeToken(TokenType::PREPROCESSOR_UNDEF, macroName);
     }
     else if (directive == "pragma") {
-        skipWhitespaceAndComments();
-        std::string pragmaText;
-        while (peek() != '\n' && peek() != '\0') {
-            pragmaText.push_back(advance());
+        skipLineSpace();
+        std::string_view pragmaText = readRestOfLine();
+        if (!includeStack_.empty() && pragmaText.substr(0, 4) == "once" &&
+            (pragmaText.size() == 4 || !charclass::isIdentContinue(pragmaText[4]))) {
+            includeStack_.back().header->pragmaOnce = true;
         }
-        return std::make_unique<Token>(TokenType::PREPROCESSOR_PRAGMA, pragmaText, startLine, startCol);
+        return makeToken(TokenType::PREPROCESSOR_PRAGMA, pragmaText);
     }
-    else if (directive == "ifdef") {
-        skipWhitespaceAndComments();
-        std::string macroName;
-        while (isalnum(peek()) || peek() == '_') {
-            macroName.push_back(advance());
-        }
-        bool defined = isMacroDefined(macroName);
-        conditionalStack_.push_back(defined && conditionalStack_.back());
-        skipping_ = !conditionalStack_.back();
-        return std::make_unique<Token>(TokenType::PREPROCESSOR_IFDEF, macroName, startLine, startCol);
+    else if (directive == "ifdef" || directive == "ifndef") {
+        skipLineSpace();
+        std::string_view macroName = readIdentifier();
+        // Inside a skipped region the condition is irrelevant
+        bool condition = !skipping_ && isMacroDefined(macroName) == (directive == "ifdef");
+        pushConditional(condition);
+        return makeToken(directive == "ifdef" ? TokenType::PREPROCESSOR_IFDEF : TokenType::PREPROCESSOR_IFNDEF,
+                         macroName);
     }
-    else if (directive == "ifndef") {
-        skipWhitespaceAndComments();
-        std::string macroName;
-        while (isalnum(peek()) || peek() == '_') {
-            macroName.push_back(advance());
+    else if (directive == "if") {
+        skipLineSpace();
+        std::string_view expr = readRestOfLine();
+        pushConditional(!skipping_ && evalIfExpression(expr));
+        return makeToken(TokenType::PREPROCESSOR_IF, expr);
+    }
+    else if (directive == "elif") {
+        skipLineSpace();
+        std::string_view expr = readRestOfLine();
+        if (conditionalStack_.size() < 2) {
+            std::cerr << "Unexpected #elif at line " << lineIndexFor(file_).lineOf(tokenStartPos_) << std::endl;
+            return makeToken(TokenType::PREPROCESSOR_ELIF, expr);
         }
-        bool defined = !isMacroDefined(macroName);
-        conditionalStack_.push_back(defined && conditionalStack_.back());
-        skipping_ = !conditionalStack_.back();
-        return std::make_unique<Token>(TokenType::PREPROCESSOR_IFNDEF, macroName, startLine, startCol);
+        // Only evaluated while no earlier branch of this #if has been taken
+        Conditional& top = conditionalStack_.back();
+        top.active = !top.taken && evalIfExpression(expr);
+        top.taken = top.taken || top.active;
+        skipping_ = !top.active;
+        return makeToken(TokenType::PREPROCESSOR_ELIF, expr);
     }
     else if (directive == "else") {
-        if (conditionalStack_.empty()) {
-            std::cerr << "Unexpected #else at line " << startLine << std::endl;
-            return std::make_unique<Token>(TokenType::PREPROCESSOR_ELSE, "", startLine, startCol);
+        if (conditionalStack_.size() < 2) {
+            std::cerr << "Unexpected #else at line " << lineIndexFor(file_).lineOf(tokenStartPos_) << std::endl;
+            return makeToken(TokenType::PREPROCESSOR_ELSE, "");
         }
-        bool previous = conditionalStack_.back();
-        conditionalStack_.pop_back();
-        bool newVal = !previous && conditionalStack_.back();
-        conditionalStack_.push_back(newVal);
-        skipping_ = !conditionalStack_.back();
-        return std::make_unique<Token>(TokenType::PREPROCESSOR_ELSE, "", startLine, startCol);
+        Conditional& top = conditionalStack_.back();
+        top.active = !top.taken;
+        top.taken = true;
+        skipping_ = !top.active;
+        return makeToken(TokenType::PREPROCESSOR_ELSE, "");
     }
     else if (directive == "endif") {
-        if (conditionalStack_.empty()) {
-            std::cerr << "Unexpected #endif at line " << startLine << std::endl;
-            return std::make_unique<Token>(TokenType::PREPROCESSOR_ENDIF, "", startLine, startCol);
+        if (conditionalStack_.size() < 2) {
+            std::cerr << "Unexpected #endif at line " << lineIndexFor(file_).lineOf(tokenStartPos_) << std::endl;
+            return makeToken(TokenType::PREPROCESSOR_ENDIF, "");
         }
         conditionalStack_.pop_back();
-        if (conditionalStack_.empty()) {
-            conditionalStack_.push_back(true);
-        }
-        skipping_ = !conditionalStack_.back();
-        return std::make_unique<Token>(TokenType::PREPROCESSOR_ENDIF, "", startLine, startCol);
-    }
-    else if (directive == "if") {
-        skipWhitespaceAndComments();
-        // Parse rest of line as expression
-        std::string expr;
-        while (peek() != '\n' && peek() != '\0') {
-            expr.push_back(advance());
-        }
-        int result = evalIfExpression(expr);
-        conditionalStack_.push_back(result != 0 && conditionalStack_.back());
-        skipping_ = !conditionalStack_.back();
-        return std::make_unique<Token>(TokenType::PREPROCESSOR_IF, expr, startLine, startCol);
-    }
-    else if (directive == "elif") {
-        if (conditionalStack_.empty()) {
-            std::cerr << "Unexpected #elif at line " << startLine << std::endl;
-            return std::make_unique<Token>(TokenType::PREPROCESSOR_ELIF, "", startLine, startCol);
-        }
-        // Pop previous condition, push new based on expression and parent's condition
-        conditionalStack_.pop_back();
-
-        skipWhitespaceAndComments();
-        std::string expr;
-        while (peek() != '\n' && peek() != '\0') {
-            expr.push_back(advance());
-        }
-        int result = evalIfExpression(expr);
-        bool parent = conditionalStack_.back();
-        conditionalStack_.push_back(result != 0 && parent);
-        skipping_ = !conditionalStack_.back();
-        return std::make_unique<Token>(TokenType::PREPROCESSOR_ELIF, expr, startLine, startCol);
+        skipping_ = !conditionalStack_.back().active;
+        return makeToken(TokenType::PREPROCESSOR_ENDIF, "");
     }
     else {
         // Unknown directive: capture rest of line
-        std::string unknownText;
-        while (peek() != '\n' && peek() != '\0') {
-            unknownText.push_back(advance());
-        }
-        return std::make_unique<Token>(TokenType::PREPROCESSOR_UNKNOWN, directive + " " + unknownText, startLine, startCol);
+        std::string_view unknownText = readRestOfLine();
+        return makeToken(TokenType::PREPROCESSOR_UNKNOWN,
+                         textArena_.concat({directive, " ", unknownText}));
     }
 }
 
-// === Expression evaluator for #if ===
+// === Conditional state ===
 
-void Lexer::skipSpaces(const std::string& expr, size_t& idx) {
-    while (idx < expr.size() && isspace(expr[idx])) idx++;
+void Lexer::pushConditional(bool condition) {
+    // Nothing inside a skipped region is compiled, whatever its conditions say
+    bool active = condition && conditionalStack_.back().active;
+    conditionalStack_.push_back(Conditional{active, active || !conditionalStack_.back().active});
+    skipping_ = !active;
 }
 
-bool Lexer::matchKeyword(const std::string& expr, size_t& idx, const std::string& keyword) {
-    size_t len = keyword.size();
-    if (expr.compare(idx, len, keyword) == 0) {
-        idx += len;
-        return true;
-    }
-    return false;
-}
+// === Expression evaluator for #if ===
+//
+// Precedence climbing straight over the directive text: no token list, no
+// strings, no std::function. Values are intmax_t or uintmax_t, as in the
+// standard: a 'u' suffix makes a literal unsigned, and an unsigned operand
+// makes the arithmetic and comparisons unsigned (so -1 < 0u is false).
+// Unlike a real preprocessor it does not expand macros textually: an
+// object-like macro stands for its replacement evaluated on its own, as if
+// parenthesized, and a function-like one (with its arguments) for 0, as
+// does any other identifier. A macro met inside its own replacement stops
+// expanding and also counts as 0.
+
+namespace {
+
+enum class IfOp { None, Mul, Div, Mod, Add, Sub, Shl, Shr, Lt, Gt, Le, Ge, Eq, Ne,
+                  BitAnd, BitXor, BitOr, And, Or, Cond };
+
+// Signed and unsigned values share the bits of an intmax_t
+struct IfValue {
+    intmax_t bits = 0;
+    bool isUnsigned = false;
+};
 
-// int Lexer::evalIfExpression(const std::string& expr) {
-//     size_t idx = 0;
-//     try {
-//         int val = preparseExpression(expr, idx);
-//         skipSpaces(expr, idx);
-//         if (idx != expr.size()) {
-//             std::cerr << "Warning: extra tokens after expression in #if" << std::endl;
-//         }
-//         return val;
-//     }
-//     catch (const std::exception& e) {
-//         std::cerr << "Error evaluating #if expression: " << e.what() << std::endl;
-//         return 0;
-//     }
-// }
-int Lexer::evalIfExpression(const std::string& expr) {
-    size_t idx = 0;
-
-    // Basic recursive-descent parser for expressions
-    // Supports: integers, +, -, *, /, %, parentheses, defined(X)
-
-    std::function<int()> parseExpression;
-    std::function<int()> parseTerm;
-    std::function<int()> parseFactor;
-
-    auto skipSpaces = [&](void) {
-        while (idx < expr.size() && isspace(expr[idx])) idx++;
-    };
+struct IfBinary {
+    IfOp op;
+    int precedence;   // Higher binds tighter
+    int length;
+};
 
-    auto matchChar = [&](char ch) -> bool {
-        skipSpaces();
-        if (idx < expr.size() && expr[idx] == ch) {
-            idx++;
-            return true;
-        }
-        return false;
-    };
+constexpr int kCondPrecedence = 1;
+constexpr int kMaxIfNesting = 256;      // Parentheses, unary operators and macro levels
 
-    auto parseNumber = [&]() -> int {
-        skipSpaces();
-        int sign = 1;
-        if (matchChar('-')) sign = -1;
-        else if (matchChar('+')) sign = 1;
+// Wrapping arithmetic without signed-overflow UB
+intmax_t wrapAdd(intmax_t a, intmax_t b) { return static_cast<intmax_t>(static_cast<uintmax_t>(a) + static_cast<uintmax_t>(b)); }
+intmax_t wrapSub(intmax_t a, intmax_t b) { return static_cast<intmax_t>(static_cast<uintmax_t>(a) - static_cast<uintmax_t>(b)); }
+intmax_t wrapMul(intmax_t a, intmax_t b) { return static_cast<intmax_t>(static_cast<uintmax_t>(a) * static_cast<uintmax_t>(b)); }
 
-        int value = 0;
-        while (idx < expr.size() && isdigit(expr[idx])) {
-            value = value * 10 + (expr[idx++] - '0');
-        }
-        return sign * value;
-    };
+} // unnamed namespace
 
-    parseFactor = [&]() -> int {
-        skipSpaces();
-        if (matchChar('(')) {
-            int val = parseExpression();
-            matchChar(')');
-            return val;
-        } else if (expr.compare(idx, 7, "defined") == 0) {
-            idx += 7;
-            skipSpaces();
-            std::string macroName;
-
-            if (matchChar('(')) {
-                while (idx < expr.size() && (isalnum(expr[idx]) || expr[idx] == '_')) {
-                    macroName += expr[idx++];
-                }
-                matchChar(')');
+struct Lexer::IfEvaluator {
+    const Lexer& lexer;
+    std::string_view text;
+    int nesting;                    // Shared budget across parentheses and macro levels
+    std::string_view macro = {};    // Macro whose replacement text is (empty at the top)
+    const IfEvaluator* outer = nullptr;   // Evaluator that met macro
+    size_t pos = 0;
+    const char* error = nullptr;    // First problem found (static string)
+
+    char at(size_t i) const { return i < text.size() ? text[i] : '\0'; }
+
+    void fail(const char* message) {
+        if (!error) error = message;
+        pos = text.size();   // Stop consuming; every caller unwinds with 0
+    }
+
+    void skipSpace() {
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (charclass::isSpace(c)) {
+                pos++;
+            } else if (size_t splice = scan::spliceLength(text.data() + pos, text.data() + text.size())) {
+                pos += splice;
+            } else if (c == '/' && at(pos + 1) == '/') {
+                pos = text.size();
+            } else if (c == '/' && at(pos + 1) == '*') {
+                size_t close = text.find("*/", pos + 2);
+                pos = close == std::string_view::npos ? text.size() : close + 2;
             } else {
-                while (idx < expr.size() && (isalnum(expr[idx]) || expr[idx] == '_')) {
-                    macroName += expr[idx++];
-                }
+                break;
             }
-            return isMacroDefined(macroName) ? 1 : 0;
-        } else {
-            return parseNumber();
         }
-    };
+    }
 
-    parseTerm = [&]() -> int {
-        int val = parseFactor();
-        while (true) {
-            if (matchChar('*')) val *= parseFactor();
-            else if (matchChar('/')) val /= parseFactor();
-            else if (matchChar('%')) val %= parseFactor();
-            else break;
-        }
-        return val;
-    };
+    // Whole expression; false on a malformed one
+    bool evaluate(IfValue& value) {
+        value = expression(kCondPrecedence, true);
+        skipSpace();
+        if (!error && pos != text.size()) fail("unexpected text after expression");
+        return error == nullptr;
+    }
 
-    parseExpression = [&]() -> int {
-        int val = parseTerm();
-        while (true) {
-            if (matchChar('+')) val += parseTerm();
-            else if (matchChar('-')) val -= parseTerm();
-            else break;
+    IfBinary peekBinary() {
+        skipSpace();
+        char c = at(pos), d = at(pos + 1);
+        switch (c) {
+        case '*': return {IfOp::Mul, 11, 1};
+        case '/': return {IfOp::Div, 11, 1};
+        case '%': return {IfOp::Mod, 11, 1};
+        case '+': return {IfOp::Add, 10, 1};
+        case '-': return {IfOp::Sub, 10, 1};
+        case '<': return d == '<' ? IfBinary{IfOp::Shl, 9, 2} : d == '=' ? IfBinary{IfOp::Le, 8, 2} : IfBinary{IfOp::Lt, 8, 1};
+        case '>': return d == '>' ? IfBinary{IfOp::Shr, 9, 2} : d == '=' ? IfBinary{IfOp::Ge, 8, 2} : IfBinary{IfOp::Gt, 8, 1};
+        case '=': return d == '=' ? IfBinary{IfOp::Eq, 7, 2} : IfBinary{IfOp::None, 0, 0};
+        case '!': return d == '=' ? IfBinary{IfOp::Ne, 7, 2} : IfBinary{IfOp::None, 0, 0};
+        case '&': return d == '&' ? IfBinary{IfOp::And, 3, 2} : IfBinary{IfOp::BitAnd, 6, 1};
+        case '^': return {IfOp::BitXor, 5, 1};
+        case '|': return d == '|' ? IfBinary{IfOp::Or, 2, 2} : IfBinary{IfOp::BitOr, 4, 1};
+        case '?': return {IfOp::Cond, kCondPrecedence, 1};
+        default:  return {IfOp::None, 0, 0};
         }
-        return val;
-    };
-
-    try {
-        int result = parseExpression();
-        return result;
-    } catch (...) {
-        std::cerr << "Error evaluating #if expression: " << expr << std::endl;
-        return 0;
     }
-}
 
-// Grammar and precedence:
-
-// expression -> logical_or
-// logical_or -> logical_and ('||' logical_and)*
-// logical_and -> equality ('&&' equality)*
-// equality -> relational (('==' | '!=') relational)*
-// relational -> unary (('<' | '>' | '<=' | '>=') unary)*
-// unary -> ('!' | '-' | '+') unary | primary
-// primary -> INTEGER | defined(identifier) | '(' expression ')'
+    // Operators binding at least as tightly as minPrecedence. When live is
+    // false the operand is not evaluated (the unused side of && || ?:), so
+    // a division by zero there is not an error.
+    IfValue expression(int minPrecedence, bool live) {
+        IfValue left = unary(live);
+        while (!error) {
+            IfBinary binary = peekBinary();
+            if (binary.op == IfOp::None || binary.precedence < minPrecedence) break;
+            pos += binary.length;
+
+            if (binary.op == IfOp::Cond) {
+                IfValue whenTrue = expression(kCondPrecedence, live && left.bits != 0);
+                skipSpace();
+                if (at(pos) != ':') {
+                    fail("expected ':' in conditional expression");
+                    return {};
+                }
+                pos++;
+                IfValue whenFalse = expression(kCondPrecedence, live && left.bits == 0);   // Right-associative
+                left = left.bits != 0 ? whenTrue : whenFalse;
+                left.isUnsigned = whenTrue.isUnsigned || whenFalse.isUnsigned;
+                continue;
+            }
 
-// Parsing helpers:
+            bool rightLive = live && !(binary.op == IfOp::And && left.bits == 0) && !(binary.op == IfOp::Or && left.bits != 0);
+            IfValue right = expression(binary.precedence + 1, rightLive);
+            left = apply(binary.op, left, right, rightLive);
+        }
+        return error ? IfValue{} : left;
+    }
 
-int Lexer::preparseExpression(const std::string& expr, size_t& idx) {
-    return preparseLogicalOr(expr, idx);
-}
+    IfValue apply(IfOp op, IfValue left, IfValue right, bool live) {
+        intmax_t a = left.bits, b = right.bits;
+        uintmax_t ua = static_cast<uintmax_t>(a), ub = static_cast<uintmax_t>(b);
+        bool u = left.isUnsigned || right.isUnsigned;   // Usual arithmetic conversions
+        bool shiftOut = right.isUnsigned ? ub >= 64 : (b < 0 || b >= 64);
+        switch (op) {
+        case IfOp::Mul: return {wrapMul(a, b), u};
+        case IfOp::Div:
+        case IfOp::Mod:
+            if (b == 0) {
+                if (live) fail("division by zero");
+                return {0, u};
+            }
+            if (u) return {static_cast<intmax_t>(op == IfOp::Div ? ua / ub : ua % ub), true};
+            if (b == -1) return {op == IfOp::Div ? wrapSub(0, a) : 0, false};   // INTMAX_MIN / -1 overflows
+            return {op == IfOp::Div ? a / b : a % b, false};
+        case IfOp::Add: return {wrapAdd(a, b), u};
+        case IfOp::Sub: return {wrapSub(a, b), u};
+        // A shift has the type of its left operand
+        case IfOp::Shl: return {shiftOut ? 0 : static_cast<intmax_t>(ua << b), left.isUnsigned};
+        case IfOp::Shr:
+            if (left.isUnsigned) return {shiftOut ? 0 : static_cast<intmax_t>(ua >> b), true};
+            return {shiftOut ? (a < 0 ? -1 : 0) : a >> b, false};
+        case IfOp::Lt: return {u ? ua < ub : a < b};
+        case IfOp::Gt: return {u ? ua > ub : a > b};
+        case IfOp::Le: return {u ? ua <= ub : a <= b};
+        case IfOp::Ge: return {u ? ua >= ub : a >= b};
+        case IfOp::Eq: return {a == b};
+        case IfOp::Ne: return {a != b};
+        case IfOp::BitAnd: return {a & b, u};
+        case IfOp::BitXor: return {a ^ b, u};
+        case IfOp::BitOr: return {a | b, u};
+        case IfOp::And: return {a != 0 && b != 0};
+        case IfOp::Or: return {a != 0 || b != 0};
+        default: return {};
+        }
+    }
 
-int Lexer::preparseLogicalOr(const std::string& expr, size_t& idx) {
-    int left = preparseLogicalAnd(expr, idx);
-    while (true) {
-        skipSpaces(expr, idx);
-        if (expr.compare(idx, 2, "||") == 0) {
-            idx += 2;
-            int right = preparseLogicalAnd(expr, idx);
-            left = (left || right) ? 1 : 0;
+    IfValue unary(bool live) {
+        if (--nesting < 0) {
+            fail("expression nested too deeply");
+            return {};
         }
-        else {
-            break;
+        skipSpace();
+        IfValue value;
+        switch (at(pos)) {
+        case '!': pos++; value = {unary(live).bits == 0}; break;
+        case '~': pos++; value = unary(live); value.bits = ~value.bits; break;
+        case '-': pos++; value = unary(live); value.bits = wrapSub(0, value.bits); break;
+        case '+': pos++; value = unary(live); break;
+        default:  value = primary(live); break;
         }
+        nesting++;
+        return error ? IfValue{} : value;
     }
-    return left;
-}
 
-int Lexer::preparseLogicalAnd(const std::string& expr, size_t& idx) {
-    int left = preparseEquality(expr, idx);
-    while (true) {
-        skipSpaces(expr, idx);
-        if (expr.compare(idx, 2, "&&") == 0) {
-            idx += 2;
-            int right = preparseEquality(expr, idx);
-            left = (left && right) ? 1 : 0;
-        }
-        else {
-            break;
+    IfValue primary(bool live) {
+        char c = at(pos);
+        if (c == '(') {
+            pos++;
+            IfValue value = expression(kCondPrecedence, live);
+            skipSpace();
+            if (at(pos) != ')') {
+                fail("expected ')'");
+                return {};
+            }
+            pos++;
+            return value;
         }
+        if (charclass::isDigit(c)) return number();
+        if (c == '\'') return {character()};
+        if (charclass::isIdentStart(c)) return identifier(live);
+        fail(pos < text.size() ? "expected a value" : "missing expression");
+        return {};
     }
-    return left;
-}
 
-int Lexer::preparseEquality(const std::string& expr, size_t& idx) {
-    int left = preparseRelational(expr, idx);
-    while (true) {
-        skipSpaces(expr, idx);
-        if (expr.compare(idx, 2, "==") == 0) {
-            idx += 2;
-            int right = preparseRelational(expr, idx);
-            left = (left == right) ? 1 : 0;
+    IfValue number() {
+        int base = 10;
+        if (at(pos) == '0' && (at(pos + 1) == 'x' || at(pos + 1) == 'X')) {
+            base = 16;
+            pos += 2;
+        } else if (at(pos) == '0' && (at(pos + 1) == 'b' || at(pos + 1) == 'B')) {
+            base = 2;
+            pos += 2;
+        } else if (at(pos) == '0') {
+            base = 8;
         }
-        else if (expr.compare(idx, 2, "!=") == 0) {
-            idx += 2;
-            int right = preparseRelational(expr, idx);
-            left = (left != right) ? 1 : 0;
+        uintmax_t value = 0;
+        bool any = base == 8;   // A lone "0" is a complete octal literal
+        while (true) {
+            char c = at(pos);
+            if (c == '\'' && charclass::digitValue(at(pos + 1)) < base) {   // Digit separator
+                pos++;
+                continue;
+            }
+            int digit = charclass::digitValue(c);
+            if (digit >= base) break;
+            value = value * base + digit;
+            any = true;
+            pos++;
         }
-        else {
-            break;
+        bool isUnsigned = value > static_cast<uintmax_t>(INTMAX_MAX);   // Too big for intmax_t
+        for (; at(pos) == 'u' || at(pos) == 'U' || at(pos) == 'l' || at(pos) == 'L'; pos++) {
+            if (at(pos) == 'u' || at(pos) == 'U') isUnsigned = true;
         }
+        if (!any || charclass::isIdentContinue(at(pos)) || at(pos) == '.') {
+            fail("invalid integer literal");
+            return {};
+        }
+        return {static_cast<intmax_t>(value), isUnsigned};
     }
-    return left;
-}
 
-int Lexer::preparseRelational(const std::string& expr, size_t& idx) {
-    int left = preparseUnary(expr, idx);
-    while (true) {
-        skipSpaces(expr, idx);
-        if (expr.compare(idx, 2, "<=") == 0) {
-            idx += 2;
-            int right = preparseUnary(expr, idx);
-            left = (left <= right) ? 1 : 0;
-        }
-        else if (expr.compare(idx, 2, ">=") == 0) {
-            idx += 2;
-            int right = preparseUnary(expr, idx);
-            left = (left >= right) ? 1 : 0;
-        }
-        else if (expr.compare(idx, 1, "<") == 0) {
-            idx += 1;
-            int right = preparseUnary(expr, idx);
-            left = (left < right) ? 1 : 0;
-        }
-        else if (expr.compare(idx, 1, ">") == 0) {
-            idx += 1;
-            int right = preparseUnary(expr, idx);
-            left = (left > right) ? 1 : 0;
+    intmax_t character() {
+        pos++;   // Opening quote
+        intmax_t value = static_cast<unsigned char>(at(pos));
+        if (at(pos) == '\\') {
+            char e = at(++pos);
+            switch (e) {
+            case 'n': value = '\n'; break;
+            case 't': value = '\t'; break;
+            case 'r': value = '\r'; break;
+            case 'a': value = '\a'; break;
+            case 'b': value = '\b'; break;
+            case 'f': value = '\f'; break;
+            case 'v': value = '\v'; break;
+            case 'x':
+                value = 0;
+                while (charclass::isHexDigit(at(pos + 1))) value = value * 16 + charclass::digitValue(at(++pos));
+                break;
+            default:
+                if (e >= '0' && e <= '7') {
+                    value = e - '0';
+                    for (int i = 0; i < 2 && at(pos + 1) >= '0' && at(pos + 1) <= '7'; ++i) {
+                        value = value * 8 + (at(++pos) - '0');
+                    }
+                } else {
+                    value = static_cast<unsigned char>(e);   // \\ \' \" \?
+                }
+                break;
+            }
         }
-        else {
-            break;
+        pos++;
+        if (at(pos) != '\'') {
+            fail("invalid character literal");
+            return 0;
         }
+        pos++;
+        return value;
     }
-    return left;
-}
 
-int Lexer::preparseUnary(const std::string& expr, size_t& idx) {
-    skipSpaces(expr, idx);
-    if (expr.compare(idx, 1, "!") == 0) {
-        idx++;
-        int val = preparseUnary(expr, idx);
-        return !val ? 1 : 0;
-    }
-    else if (expr.compare(idx, 1, "-") == 0) {
-        idx++;
-        int val = preparseUnary(expr, idx);
-        return -val;
-    }
-    else if (expr.compare(idx, 1, "+") == 0) {
-        idx++;
-        return preparseUnary(expr, idx);
-    }
-    else {
-        return preparsePrimary(expr, idx);
-    }
-}
-
-int Lexer::preparsePrimary(const std::string& expr, size_t& idx) {
-    skipSpaces(expr, idx);
-    if (idx >= expr.size()) throw std::runtime_error("Unexpected end of expression");
+    IfValue identifier(bool live) {
+        size_t start = pos;
+        while (charclass::isIdentContinue(at(pos))) pos++;
+        std::string_view name = text.substr(start, pos - start);
+
+        if (name == "defined") {
+            skipSpace();
+            bool paren = at(pos) == '(';
+            if (paren) {
+                pos++;
+                skipSpace();
+            }
+            size_t nameStart = pos;
+            while (charclass::isIdentContinue(at(pos))) pos++;
+            std::string_view macroName = text.substr(nameStart, pos - nameStart);
+            if (macroName.empty()) {
+                fail("expected a macro name after 'defined'");
+                return {};
+            }
+            if (paren) {
+                skipSpace();
+                if (at(pos) != ')') {
+                    fail("expected ')' after 'defined'");
+                    return {};
+                }
+                pos++;
+            }
+            return {lexer.isMacroDefined(macroName)};
+        }
+        if (name == "true") return {1};
+        if (name == "false") return {};
 
-    // Handle (expr)
-    if (expr[idx] == '(') {
-        idx++;
-        int val = preparseExpression(expr, idx);
-        skipSpaces(expr, idx);
-        if (idx >= expr.size() || expr[idx] != ')') {
-            throw std::runtime_error("Expected ')'");
+        auto it = lexer.macros_.find(name);
+        if (it == lexer.macros_.end()) return {};
+        for (const IfEvaluator* e = this; e; e = e->outer) {
+            if (e->macro == name) return {};   // Inside its own replacement: not expanded again
         }
-        idx++;
-        return val;
-    }
 
-    // Handle defined identifier
-    if (matchKeyword(expr, idx, "defined")) {
-        skipSpaces(expr, idx);
-        bool hasParen = false;
-        if (idx < expr.size() && expr[idx] == '(') {
-            hasParen = true;
-            idx++;
-            skipSpaces(expr, idx);
+        const Macro& macro = it->second;
+        if (macro.functionLike) {
+            // Step over the argument list, if any; the call counts as 0
+            size_t save = pos;
+            skipSpace();
+            if (at(pos) != '(') {
+                pos = save;
+                return {};
+            }
+            for (int depth = 0; pos < text.size(); ++pos) {
+                if (text[pos] == '(') depth++;
+                else if (text[pos] == ')' && --depth == 0) break;
+            }
+            if (pos == text.size()) {
+                fail("unterminated macro arguments");
+                return {};
+            }
+            pos++;
+            return {};
         }
-        std::string macroName;
-        while (idx < expr.size() && (isalnum(expr[idx]) || expr[idx] == '_')) {
-            macroName.push_back(expr[idx++]);
+
+        // Evaluate the replacement on its own, sharing the nesting budget so a
+        // long chain of macros runs out instead of overflowing the stack
+        IfEvaluator inner{lexer, macro.definition, nesting - 1, name, this};
+        if (inner.nesting < 0) {
+            fail("macro expansion nested too deeply");
+            return {};
         }
-        if (hasParen) {
-            skipSpaces(expr, idx);
-            if (idx >= expr.size() || expr[idx] != ')') {
-                throw std::runtime_error("Expected ')' after defined");
-            }
-            idx++;
+        IfValue value;
+        if (!inner.evaluate(value)) {
+            if (live) fail("macro does not expand to an integer expression");
+            return {};
         }
-        return isMacroDefined(macroName) ? 1 : 0;
+        return value;
     }
+};
 
-    // Parse number literal
-    if (isdigit(expr[idx])) {
-        int start = idx;
-        while (idx < expr.size() && isdigit(expr[idx])) idx++;
-        int val = std::stoi(expr.substr(start, idx - start));
-        return val;
+bool Lexer::evalIfExpression(std::string_view expr) const {
+    IfEvaluator evaluator{*this, expr, kMaxIfNesting};
+    IfValue value;
+    if (!evaluator.evaluate(value)) {
+        std::cerr << "Error evaluating #if expression: " << expr << " (" << evaluator.error << ")" << std::endl;
+        return false;
     }
-
-    // Otherwise error
-    throw std::runtime_error(std::string("Unexpected token in #if expression at position ") + std::to_string(idx));
+    return value.bits != 0;
 }
@@ -2,79 +2,267 @@
 #define LEXER_HPP
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <unordered_map>
 #include <stack>
+#include <array>
 #include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\tokens.hpp"
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\line_index.hpp"
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\include_resolver.hpp"
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\arena.hpp"
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\token_buffer.hpp"
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\macro_filter.hpp"
+
+// Result of Lexer::relex(): the full token list for the edited source, and
+// which part of it is new. tokens[firstChanged, lastChanged) replaces
+// previous[firstChanged, replacedEnd); everything else was carried over.
+struct RelexResult {
+    std::vector<Token> tokens;
+    size_t firstChanged = 0;
+    size_t lastChanged = 0;
+    size_t replacedEnd = 0;
+};
 
 class Lexer {
 public:
-    explicit Lexer(const std::string& source);
+    // The lexer does not copy the source; the buffer must outlive the Lexer
+    // and every Token it returns.
+    explicit Lexer(std::string_view source);
 
     // Tokenize the entire source code and return a vector of tokens
-    std::vector<std::unique_ptr<Token>> tokenize();
-    
+    std::vector<Token> tokenize();
+
+    // Same tokens as tokenize(), stored column by column (about a third of
+    // the memory); the buffer views into this Lexer like its Tokens do.
+    TokenBuffer tokenizePacked();
+
+    // Same result as tokenize(), token for token, but chunks of the buffer are
+    // lexed speculatively on worker threads first (0 = one per hardware thread).
+    // Small inputs, or a lexer that has already started, fall back to tokenize().
+    static constexpr size_t kParallelMinBytes = 1 << 20;
+    std::vector<Token> tokenizeParallel(unsigned threadCount = 0);
+
+    // Re-lex after an edit. previous must be the complete token list this
+    // lexer produced for its current source. Bytes [editStart, oldEditEnd) of
+    // that source were replaced, giving newSource in which the replacement
+    // spans [editStart, newEditEnd). Lexing restarts at the last token before
+    // the edit, with the preprocessor state rebuilt from the directives ahead
+    // of it, and stops once the stream lines up with previous again (unless a
+    // directive was involved). The lexer then refers to newSource, which must
+    // outlive it; the old buffer is only compared against, never read.
+    // If previous pulled in #included files, everything is lexed again.
+    RelexResult relex(const std::vector<Token>& previous, std::string_view newSource,
+                      size_t editStart, size_t oldEditEnd, size_t newEditEnd);
+
+    // Hash of the macros currently defined (names and values, order-independent);
+    // part of the token cache key, since macros change the token stream.
+    uint64_t macroFingerprint() const;
+
+    // --- Streaming interface ---
+    // Tokens are produced on demand; the lexer never runs ahead of the
+    // consumer by more than kMaxLookahead tokens.
+    static constexpr size_t kMaxLookahead = 4;
+
+    Token nextToken();                    // Consume and return the next token
+    const Token& peekToken(size_t k = 0); // Look k tokens ahead without consuming (k < kMaxLookahead)
+
+    // --- #include ---
+    // Without a resolver, #include only produces its directive token. With
+    // one (which must outlive the Lexer and its tokens), the named file's
+    // tokens follow it; mainPath is where this lexer's source came from, for
+    // resolving quoted includes. Headers guarded by #pragma once or an
+    // #ifndef guard are not re-read once the guard is known to hold.
+    static constexpr size_t kMaxIncludeDepth = 200;
+    void setIncludeResolver(IncludeResolver* resolver, std::string mainPath = {});
+
+    // --- Positions ---
+    // Tokens carry byte offsets only; line/column are computed on request.
+    const LineIndex& lineIndex() const { return lineIndex_; }   // Of the main source (file 0)
+    const LineIndex& lineIndexFor(uint16_t file) const;
+    int lineOf(const Token& token) const { return lineIndexFor(token.file()).lineOf(token.offset()); }
+    int columnOf(const Token& token) const { return lineIndexFor(token.file()).columnOf(token.offset()); }
+    std::string_view fileName(uint16_t file) const;   // Path of an included file, or mainPath (may be empty)
+
+    // --- Macro lookup statistics ---
+    // Every identifier is checked against the defined macros; the filter
+    // turns most of them away before the hash map is consulted.
+    struct MacroLookupStats {
+        uint64_t lookups = 0;          // Identifiers checked while macros were defined
+        uint64_t filtered = 0;         // Rejected by the filter alone
+        uint64_t falsePositives = 0;   // Passed the filter but were not macros
+    };
+    const MacroLookupStats& macroLookupStats() const { return macroStats_; }
+
+    // --- Memory ---
+    // Synthesized token text (pasted, stringized, directive summaries)
+    const Arena& textArena() const { return textArena_; }
 
 private:
-    const std::string& source_;   // Source code to tokenize
+    std::string_view source_;     // Source code to tokenize (not owned)
     size_t pos_ = 0;              // Current position in source_
-    int line_ = 1;                // Current line number (starts at 1)
-    int column_ = 1;              // Current column number (starts at 1)
+    LineIndex lineIndex_;         // Offset -> line/column, built lazily
     std::string errorMessage_;    // error message
 
     size_t tokenStartPos_ = 0;    // Start position of the current token
 
-    // Macro definitions: macro name -> replacement text
-    std::unordered_map<std::string, std::string> macros_;
+    // A #define, with its replacement list lexed once when it is defined
+    struct Macro {
+        std::vector<Token> body;                // Replacement tokens (views into source_)
+        std::vector<std::string_view> params;   // Parameter names; "__VA_ARGS__" last if variadic
+        bool functionLike = false;
+        bool variadic = false;
+        std::string_view definition;            // Everything after the name, as written
+        std::vector<Token> expansion;           // Memoized top-level expansion (object-like only)
+        uint64_t expansionGeneration = 0;       // macroGeneration_ the memo belongs to (0 = none)
+    };
+
+    // Macro definitions, keyed by name (a view into source_)
+    std::unordered_map<std::string_view, Macro> macros_;
+    MacroFilter macroFilter_;           // Holds exactly the names in macros_
+    MacroLookupStats macroStats_;
+    uint64_t macroGeneration_ = 1;      // Bumped by #define/#undef; stale memos are rebuilt
 
-    // Stack tracking conditional compilation states (#ifdef, #ifndef, #else, #endif)
-    std::vector<bool> conditionalStack_;
+    // Tokens of the current macro expansion not yet handed out by lexNext()
+    std::vector<Token> pending_;
+    size_t pendingIndex_ = 0;
+    bool lastFromExpansion_ = false;    // The last token lexNext() returned came from pending_
+    std::vector<std::string_view> activeMacros_;   // Reused by expandInvocation()
+
+    // Backing storage for token text that does not exist verbatim in source_
+    // (pasted, stringized and directive tokens); views stay valid for the Lexer's lifetime
+    Arena textArena_;
+    std::string scratch_;               // Reused buffer for building stringized text
+
+    // Open conditionals (#if, #ifdef, #ifndef), innermost last. The bottom
+    // entry stands for the file itself and is never popped.
+    struct Conditional {
+        bool active;   // This branch and every enclosing one are compiled
+        bool taken;    // A branch has been chosen, so any later #elif/#else is skipped
+    };
+    std::vector<Conditional> conditionalStack_;
 
     // If true, lexer is currently skipping tokens due to false condition in preprocessing
     bool skipping_ = false;
 
+    // Lookahead ring buffer filled by peekToken() and drained by nextToken()
+    std::array<Token, kMaxLookahead> lookahead_;
+    size_t lookaheadHead_ = 0;    // Index of the oldest buffered token
+    size_t lookaheadCount_ = 0;   // Number of buffered tokens
+
+    // Tokens lexed ahead of time by tokenizeParallel() workers, sorted by
+    // offset. One is reused only when the real lexer arrives exactly at its
+    // offset outside a skipped region; everything else is lexed normally.
+    std::vector<Token> speculative_;
+    std::vector<uint32_t> speculativeResume_;   // Where lexing continues after each token
+    size_t speculativeCursor_ = 0;
+    bool internSymbols_ = true;   // False on worker threads, whose identifiers are interned on adoption
+
+    // A header being read. source_/pos_ point into it; the frame remembers
+    // where to return to in the includer, and watches the header's
+    // directives for an include guard wrapping all of it.
+    struct IncludeFrame {
+        enum class Guard { Start, Open, Closed, None };
+
+        std::string_view source;        // Includer's buffer, position and file id
+        size_t pos;
+        uint16_t file;
+        size_t conditionalDepth;        // conditionalStack_ size on entry
+        SourceFile* header;
+        Guard guard;
+        std::string_view guardMacro;    // Name from the leading #ifndef
+        size_t guardDepth;              // conditionalStack_ size inside that #ifndef
+    };
+
+    IncludeResolver* includes_ = nullptr;
+    std::string mainPath_;
+    uint16_t file_ = 0;                     // File source_ belongs to (0 = the constructor's source)
+    std::vector<IncludeFrame> includeStack_;
+    std::vector<bool> entered_;             // By file id: included at least once by this lexer
+
+    Token lexNext();              // Lex exactly one token (directives and macros applied)
+    bool takeSpeculative(Token& token);   // Reuse the speculative token at pos_, if any
+    void speculateChunk(size_t begin, size_t end, bool last,
+                        std::vector<Token>& tokens, std::vector<uint32_t>& resume) const;
+
     // --- Helper methods for character reading ---
     char peek() const;            // Look at current character without advancing
     char peekNext() const;        // Look at next character without advancing
     char advance();               // Consume current character and advance position
     bool match(char expected);    // If current char matches expected, consume it and return true
+    void advanceTo(size_t target);  // Consume everything up to target
 
     void skipWhitespaceAndComments();  // Skip spaces, tabs, newlines, and comments
+    void skipLineSpace();              // Same, but stop at the end of the line (for directives)
+    void skipInactiveRegion();         // Jump to the next line starting with '#' (or EOF)
+
+    std::string_view readIdentifier();    // Consume [A-Za-z0-9_]* and return it as a view
+    std::string_view readRestOfLine();    // Consume up to the newline (following '\\' continuations)
 
     // --- Lexing different types of tokens ---
-    std::unique_ptr<Token> lexToken();
-    std::unique_ptr<Token> lexIdentifierOrKeyword();
-    std::unique_ptr<Token> lexNumber();
-    std::unique_ptr<Token> lexString();
-    std::unique_ptr<Token> lexChar();
-    std::unique_ptr<Token> lexPreprocessorDirective();
+    Token lexToken();
+    Token lexIdentifierOrKeyword();
+    Token lexNumber();
+    Token lexString();
+    Token lexChar();
+    Token lexQuoted(char quote, TokenType type, std::string_view unterminatedMessage);
+    Token lexPreprocessorDirective();
+    bool lexDirective(Token& token);      // Same, but false for a directive in a skipped region (no token)
+
+    // --- #include helpers ---
+    void enterInclude(std::string_view name, bool angled);
+    bool leaveInclude();                  // At the end of a header: resume the includer
+    void trackIncludeGuard(IncludeFrame& frame, const Token& token);
 
     // --- Macro handling helpers ---
-    void defineMacro(const std::string& name, const std::string& value);
-    bool isMacroDefined(const std::string& name) const;
-    void updateSkipping();                // Update skipping_ state based on conditionalStack_
+    // Reads tokens from a list and, once that runs out, optionally from the
+    // source (a macro call whose arguments continue past an expansion).
+    struct TokenCursor {
+        const std::vector<Token>* list;
+        size_t index;
+        bool fromSource;
+    };
+
+    void defineMacro(std::string_view name, Macro macro);
+    void undefineMacro(std::string_view name);
+    bool isMacroDefined(std::string_view name) const;
+    void pushConditional(bool condition); // Open an #if/#ifdef/#ifndef and update skipping_
 
-    std::string expandMacro(const std::string& text) const;  // Expand macro if defined
+    Token lexRaw();                       // Next source token, no directives or expansion
+    std::vector<Token> lexMacroBody(std::string_view text, size_t offset);
+    Macro* findMacro(Token& token, const std::vector<std::string_view>& active);   // Marks no_expand if active
+    bool expandInvocation(const Token& name, Macro& macro);   // Fills pending_
+    void expandList(const std::vector<Token>& in, bool sourceTail, std::vector<Token>& out,
+                    std::vector<std::string_view>& active, uint32_t offset);
+    void expandObject(std::string_view name, Macro& macro, std::vector<Token>& out,
+                      std::vector<std::string_view>& active, uint32_t offset);
+    void expandFunction(std::string_view name, const Macro& macro,
+                        const std::vector<std::vector<Token>>& args, bool sourceTail,
+                        std::vector<Token>& out, std::vector<std::string_view>& active, uint32_t offset);
+    bool expandCall(const Token& name, const Macro& macro, TokenCursor& cursor, std::vector<Token>& out,
+                    std::vector<std::string_view>& active, uint32_t offset);
+    bool expandTrailingCall(size_t from, TokenCursor& cursor, std::vector<Token>& out,
+                            std::vector<std::string_view>& active, uint32_t offset);
+    bool nextCursorToken(TokenCursor& cursor, Token& token);
+    bool openParenFollows(TokenCursor& cursor);
+    bool collectArguments(TokenCursor& cursor, const Macro& macro,
+                          std::vector<std::vector<Token>>& args, std::vector<Token>& consumed);
+    Token stringize(const std::vector<Token>& arg, uint32_t offset);
+    bool paste(const Token& left, const Token& right, uint32_t offset, Token& result);
 
     // --- Keyword and identifier handling ---
-    TokenType keywordLookup(const std::string& identifier) const;
+    TokenType keywordLookup(std::string_view identifier) const;
 
     // --- Token creation helpers ---
-    std::unique_ptr<Token> makeToken(TokenType type, const std::string& text);
-    std::unique_ptr<Token> errorToken(const std::string& message);
-
-    // --- Preprocessor Expression Evaluation Helpers ---
-    void skipSpaces(const std::string& expr, size_t& idx);
-    bool matchKeyword(const std::string& expr, size_t& idx, const std::string& keyword);
-    int evalIfExpression(const std::string& expr);
-    int preparseExpression(const std::string& expr, size_t& idx);
-    int preparseLogicalOr(const std::string& expr, size_t& idx);
-    int preparseLogicalAnd(const std::string& expr, size_t& idx);
-    int preparseEquality(const std::string& expr, size_t& idx);
-    int preparseRelational(const std::string& expr, size_t& idx);
-    int preparseUnary(const std::string& expr, size_t& idx);
-    int preparsePrimary(const std::string& expr, size_t& idx);
+    void beginToken();                                  // Mark pos_ as the start of a new token
+    Token makeToken(TokenType type);                    // Token spanning [tokenStartPos_, pos_)
+    Token makeToken(TokenType type, std::string_view text);
+    Token errorToken(std::string_view message);         // message must have static storage
+
+    // --- Preprocessor expression evaluation (#if, #elif) ---
+    struct IfEvaluator;                               // Allocation-free; defined in lexer.cpp
+    bool evalIfExpression(std::string_view expr) const;   // Errors are reported and count as false
 
     // --- Utility ---
     bool isAtEnd() const;         // Check if reached end of source
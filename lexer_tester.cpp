@@ -1,19 +1,763 @@
 #include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\lexer_tester.hpp"
 #include "lexer.hpp"
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\token_cache.hpp"
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\char_class.hpp"
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\token_names.hpp"
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\parser.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 
-void testLexer(const std::string& source) {
+namespace {
+
+// Output buffer for the token dump. Lines are formatted in place (integers
+// with std::to_chars) and written out in large blocks, never flushed per line.
+class DumpWriter {
+public:
+    static constexpr size_t kFlushAt = 1 << 16;
+
+    explicit DumpWriter(std::ostream& out) : out_(out) { buffer_.reserve(kFlushAt * 2); }
+    ~DumpWriter() { flush(); }
+
+    void put(std::string_view text) { buffer_.append(text.data(), text.size()); }
+
+    void putInt(long long value) {
+        char digits[24];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer_.append(digits, result.ptr - digits);
+    }
+
+    // Six decimals, as std::fixed prints it in Token::toString()
+    void putFixed(double value) {
+        char digits[512];
+        int length = std::snprintf(digits, sizeof(digits), "%.6f", value);
+        buffer_.append(digits, static_cast<size_t>(std::max(length, 0)));
+    }
+
+    // Quoted JSON string. Bytes >= 0x80 pass through unchanged.
+    void putJsonString(std::string_view text) {
+        static const char kHex[] = "0123456789abcdef";
+        buffer_.push_back('"');
+        for (char c : text) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                buffer_.push_back('\\');
+                buffer_.push_back(c);
+            }
+            else if (c == '\n') put("\\n");
+            else if (c == '\t') put("\\t");
+            else if (c == '\r') put("\\r");
+            else if (byte < 0x20) {
+                put("\\u00");
+                buffer_.push_back(kHex[byte >> 4]);
+                buffer_.push_back(kHex[byte & 0xF]);
+            }
+            else buffer_.push_back(c);
+        }
+        buffer_.push_back('"');
+    }
+
+    void endLine() {
+        buffer_.push_back('\n');
+        if (buffer_.size() >= kFlushAt) flush();
+    }
+
+    void flush() {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        written_ += buffer_.size();
+        buffer_.clear();
+    }
+
+    size_t bytesWritten() const { return written_ + buffer_.size(); }
+
+private:
+    std::ostream& out_;
+    std::string buffer_;
+    size_t written_ = 0;
+};
+
+// Same line as Token::toString(lines)
+void dumpText(DumpWriter& out, const Token& token, const LineIndex& lines) {
+    out.put("Token(type=");
+    out.put(tokenTypeName(token.type()));
+    out.put(", text='");
+    out.put(token.view());
+    out.put("', line=");
+    out.putInt(lines.lineOf(token.offset()));
+    out.put(", column=");
+    out.putInt(lines.columnOf(token.offset()));
+    if (token.type() == TokenType::INTEGER) {
+        out.put(", int_value=");
+        out.putInt(token.int_value());
+    }
+    else if (token.type() == TokenType::FLOAT) {
+        out.put(", float_value=");
+        out.putFixed(token.float_value());
+    }
+    out.put(")");
+    out.endLine();
+}
+
+void dumpJson(DumpWriter& out, const Token& token, const LineIndex& lines) {
+    out.put("{\"type\":\"");
+    out.put(tokenTypeName(token.type()));
+    out.put("\",\"text\":");
+    out.putJsonString(token.view());
+    out.put(",\"file\":");
+    out.putInt(token.file());
+    out.put(",\"offset\":");
+    out.putInt(token.offset());
+    out.put(",\"line\":");
+    out.putInt(lines.lineOf(token.offset()));
+    out.put(",\"column\":");
+    out.putInt(lines.columnOf(token.offset()));
+    if (token.type() == TokenType::INTEGER) {
+        out.put(",\"int_value\":");
+        out.putInt(token.int_value());
+    }
+    else if (token.type() == TokenType::FLOAT) {
+        out.put(",\"float_value\":");
+        if (std::isfinite(token.float_value())) out.putFixed(token.float_value());
+        else out.put("null");
+    }
+    out.put("}");
+    out.endLine();
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double perSecond(double amount, double seconds) {
+    return seconds > 0 ? amount / seconds : 0.0;
+}
+
+double percent(uint64_t part, uint64_t whole) {
+    return whole > 0 ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+
+}
+
+void testLexer(std::string_view source, const LexerTestOptions& options) {
+    auto lexStart = std::chrono::steady_clock::now();
     Lexer lexer(source);
-    auto tokens = lexer.tokenize();
+    lexer.setIncludeResolver(options.includes, options.path);
+    std::vector<Token> tokens;
+    uint64_t macros = lexer.macroFingerprint();
+    if (options.cache && options.cache->load(source, macros, tokens)) {
+        std::cerr << "Token cache hit" << std::endl;
+    }
+    else {
+        tokens = options.parallel ? lexer.tokenizeParallel() : lexer.tokenize();
+        // The cache key only covers this source, so streams that pulled in headers are not stored
+        bool selfContained = std::none_of(tokens.begin(), tokens.end(),
+                                          [](const Token& token) { return token.file() != 0; });
+        if (options.cache && selfContained && !options.cache->store(source, macros, tokens)) {
+            std::cerr << "Warning: could not write token cache entry" << std::endl;
+        }
+    }
+    double lexSeconds = secondsSince(lexStart);
 
     // if (lexer.hasError()) {
     //     std::cerr << "Lexer error: " << lexer.getError() << std::endl;
     //     return;
     // }
 
-    std::cout << "Tokens generated: " << tokens.size() << std::endl;
-    for (const auto& token : tokens) {
-        std::cout << token->toString() << std::endl;
+    auto dumpStart = std::chrono::steady_clock::now();
+    size_t dumpBytes = 0;
+    {
+        DumpWriter out(std::cout);
+        if (options.format == DumpFormat::Text) {
+            out.put("Tokens generated: ");
+            out.putInt(static_cast<long long>(tokens.size()));
+            out.endLine();
+        }
+        for (const Token& token : tokens) {
+            const LineIndex& lines = lexer.lineIndexFor(token.file());
+            if (options.format == DumpFormat::Ndjson) dumpJson(out, token, lines);
+            else dumpText(out, token, lines);
+        }
+        out.flush();
+        dumpBytes = out.bytesWritten();
     }
-    // std::cout<<"foo"<<std::endl;
+    std::cout.flush();
+    double dumpSeconds = secondsSince(dumpStart);
+
+    if (options.stats) {
+        double megabytes = static_cast<double>(source.size()) / (1024.0 * 1024.0);
+        std::cerr << std::fixed << std::setprecision(1)
+                  << "Lexed " << tokens.size() << " tokens from " << source.size() << " bytes in "
+                  << lexSeconds * 1000.0 << " ms ("
+                  << perSecond(static_cast<double>(tokens.size()), lexSeconds) << " tokens/s, "
+                  << perSecond(megabytes, lexSeconds) << " MB/s); dumped "
+                  << dumpBytes << " bytes in " << dumpSeconds * 1000.0 << " ms ("
+                  << perSecond(static_cast<double>(tokens.size()), dumpSeconds) << " tokens/s, "
+                  << perSecond(dumpBytes / (1024.0 * 1024.0), dumpSeconds) << " MB/s)\n";
+
+        const Lexer::MacroLookupStats& macroStats = lexer.macroLookupStats();
+        uint64_t passed = macroStats.lookups - macroStats.filtered;
+        std::cerr << "Macro lookups: " << macroStats.lookups << ", rejected by filter: "
+                  << macroStats.filtered << " ("
+                  << percent(macroStats.filtered, macroStats.lookups)
+                  << "%), false positives: " << macroStats.falsePositives << " ("
+                  << percent(macroStats.falsePositives, passed)
+                  << "% of passes)\n";
+    }
+}
+
+size_t testParser(std::string_view source, const LexerTestOptions& options) {
+    Lexer lexer(source);
+    lexer.setIncludeResolver(options.includes, options.path);
+    AstArena arena;
+    Parser parser(lexer, arena);
+    ArenaPtr<ASTNode> tree = parser.parse();
+
+    for (const Diagnostic& diag : parser.diagnostics()) {
+        std::cerr << formatDiagnostic(diag, lexer) << '\n';
+    }
+    size_t declarations = static_cast<const Program*>(tree.get())->globals.size();
+    std::cout << "Parsed " << declarations << " top-level declarations, "
+              << parser.diagnostics().size() << " errors\n";
+    return parser.diagnostics().size();
+}
+
+void reportTokenMemory(std::string_view source, IncludeResolver* includes, const std::string& path) {
+    Lexer vectorLexer(source);
+    vectorLexer.setIncludeResolver(includes, path);
+    std::vector<Token> tokens = vectorLexer.tokenize();
+
+    Lexer packedLexer(source);
+    packedLexer.setIncludeResolver(includes, path);
+    TokenBuffer packed = packedLexer.tokenizePacked();
+
+    size_t mismatches = packed.size() == tokens.size() ? 0 : 1;
+    for (size_t i = 0; i < std::min(packed.size(), tokens.size()); ++i) {
+        Token token = packed[i];
+        if (token.type() != tokens[i].type() || token.view() != tokens[i].view() ||
+            token.offset() != tokens[i].offset() || token.file() != tokens[i].file() ||
+            token.symbol() != tokens[i].symbol() || token.has_escape() != tokens[i].has_escape()) {
+            mismatches++;
+        }
+    }
+
+    size_t count = std::max<size_t>(tokens.size(), 1);
+    size_t vectorBytes = tokens.capacity() * sizeof(Token);
+    std::cout << "Token memory (" << tokens.size() << " tokens)\n";
+    std::cout << "  std::vector<Token>: " << vectorBytes << " bytes ("
+              << static_cast<double>(vectorBytes) / count << " per token)\n";
+    std::cout << "  TokenBuffer:        " << packed.bytesUsed() << " bytes ("
+              << static_cast<double>(packed.bytesUsed()) / count << " per token)\n";
+    if (mismatches != 0) {
+        std::cout << "  WARNING: layouts disagree on " << mismatches << " tokens\n";
+    }
+}
+
+namespace {
+
+// Both classifiers answer the same three questions the lexer asks per byte;
+// the counts are returned so the work cannot be optimized away.
+size_t classifyWithCctype(std::string_view source) {
+    size_t hits = 0;
+    for (char ch : source) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        hits += (isalnum(c) || c == '_') ? 1 : 0;
+        hits += isdigit(c) ? 2 : 0;
+        hits += isspace(c) ? 4 : 0;
+    }
+    return hits;
+}
+
+size_t classifyWithTable(std::string_view source) {
+    size_t hits = 0;
+    for (char c : source) {
+        hits += charclass::isIdentContinue(c) ? 1 : 0;
+        hits += charclass::isDigit(c) ? 2 : 0;
+        hits += charclass::isSpace(c) ? 4 : 0;
+    }
+    return hits;
+}
+
+template <typename Fn>
+double throughputMBs(std::string_view source, int iterations, Fn fn, size_t& checksum) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        checksum += fn(source);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double megabytes = static_cast<double>(source.size()) * iterations / (1024.0 * 1024.0);
+    return elapsed.count() > 0 ? megabytes / elapsed.count() : 0.0;
+}
+
+}
+
+void benchCharClass(std::string_view source, int iterations) {
+    size_t cctypeSum = 0;
+    size_t tableSum = 0;
+    double cctypeRate = throughputMBs(source, iterations, classifyWithCctype, cctypeSum);
+    double tableRate = throughputMBs(source, iterations, classifyWithTable, tableSum);
+
+    std::cout << "Char-class benchmark (" << source.size() << " bytes x " << iterations << ")\n";
+    std::cout << "  <cctype>: " << cctypeRate << " MB/s\n";
+    std::cout << "  table:    " << tableRate << " MB/s\n";
+    if (cctypeRate > 0) {
+        std::cout << "  speedup:  " << tableRate / cctypeRate << "x\n";
+    }
+    if (cctypeSum != tableSum) {
+        std::cout << "  WARNING: classifiers disagree (" << cctypeSum << " vs " << tableSum << ")\n";
+    }
+}
+
+namespace {
+
+struct PreprocessorCase {
+    std::string_view source;
+    std::string_view expected;   // Text of the resulting tokens, space-separated
+};
+
+// Directive tokens are left out, so only what the source expands to remains
+const PreprocessorCase kPreprocessorCases[] = {
+    // A function-like name ending an object-like expansion takes its arguments from the source
+    {"#define F f\n#define f(x) x+1\nF(2)\n", "2 + 1"},
+    {"#define h g\n#define g(x) [x]\nh(3)\n", "[ 3 ]"},
+    {"#define F f\n#define f(x) x+1\nF(2) F(3)\n", "2 + 1 3 + 1"},   // The second use replays the memo
+    {"#define F f\n#define f(x) x+1\n#define G F(4)\nG\n", "4 + 1"},
+    {"#define F f\n#define f(x) x+1\nF + 1\n", "f + 1"},
+    {"#define E\n#define f(x) x\nf E (1)\n", "f ( 1 )"},
+    // A name met inside its own expansion never expands again
+    {"#define A A\nA\n", "A"},
+    {"#define g(x) g\n#define F g(1)\nF(2)\n", "g ( 2 )"},
+    // #if: a self-referential macro evaluates to 0; an unsigned operand makes the comparison unsigned
+    {"#define A A\n#if A\nyes\n#else\nno\n#endif\n", "no"},
+    {"#define A B\n#define B A + 1\n#if A\nyes\n#endif\n", "yes"},
+    {"#if -1 < 0u\nyes\n#else\nno\n#endif\n", "no"},
+    {"#if -1 < 0\nyes\n#endif\n", "yes"},
+    {"#if (0u - 1) >> 63 == 1 && -1 >> 63 == -1\nyes\n#endif\n", "yes"},
+    {"#if 18446744073709551615 > 0\nyes\n#endif\n", "yes"},
+    // Line splices in CRLF sources: backslash, '\r', '\n'
+    {"#define ADD(a,b) \\\r\n((a)+(b))\r\nint x = ADD(1,2);\r\n", "int x = ( ( 1 ) + ( 2 ) ) ;"},
+    {"#if 1 + \\\r\n1 == 2\r\nyes\r\n#endif\r\n", "yes"},
+    {"#if 0\r\n#define X \\\r\n#endif\r\nno\r\n#endif\r\nyes\r\n", "yes"},
+    {"#define MASK 0xFf\nint m = MASK & 0x1;\nint z = 0x;\n", "int m = 0xFf & 0x1 ; int z = 0 x ;"},
+    {"#if '\\x4a' == 0x4A && 0XfF == 255\nyes\n#endif\n", "yes"},
+};
+
+std::string expandedText(std::string_view source) {
+    Lexer lexer(source);
+    std::string text;
+    for (const Token& token : lexer.tokenize()) {
+        TokenType type = token.type();
+        if (type == TokenType::END_OF_FILE ||
+            (type >= TokenType::PREPROCESSOR_INCLUDE && type <= TokenType::PREPROCESSOR_UNKNOWN)) {
+            continue;
+        }
+        if (!text.empty()) text += ' ';
+        text += token.view();
+    }
+    return text;
+}
+
+}
+
+int runPreprocessorTests() {
+    int failures = 0;
+    for (const PreprocessorCase& test : kPreprocessorCases) {
+        std::string actual = expandedText(test.source);
+        if (actual != test.expected) {
+            failures++;
+            std::cout << "FAIL:\n" << test.source << "  expected: " << test.expected
+                      << "\n  actual:   " << actual << "\n";
+        }
+    }
+    size_t total = sizeof(kPreprocessorCases) / sizeof(kPreprocessorCases[0]);
+    std::cout << "Preprocessor tests: " << total - failures << "/" << total << " passed\n";
+    return failures;
+}
+
+namespace {
+
+// S-expression of a tree, for comparing two parses. Covers the nodes the
+// generated program below produces; anything else prints as its type number.
+void describe(const ASTNode* node, std::string& out) {
+    auto child = [&out](const ArenaPtr<ASTNode>& next) { out += ' '; describe(next.get(), out); };
+    if (!node) {
+        out += "null";
+        return;
+    }
+    out += '(';
+    if (auto* program = dynamic_cast<const Program*>(node)) {
+        out += "program";
+        for (auto& decl : program->globals) child(decl);
+    } else if (auto* function = dynamic_cast<const FunctionDecl*>(node)) {
+        out += "function ";
+        out += function->name.view();
+        child(function->returnType);
+        child(function->body);
+    } else if (auto* record = dynamic_cast<const StructDecl*>(node)) {
+        out += "struct " + record->name;
+        for (auto& member : record->members) child(member);
+    } else if (auto* enumeration = dynamic_cast<const EnumDecl*>(node)) {
+        out += "enum " + enumeration->name;
+        for (auto& enumerator : enumeration->enumerators) {
+            out += ' ' + enumerator.first + '=' + std::to_string(enumerator.second);
+        }
+    } else if (auto* var = dynamic_cast<const VarDecl*>(node)) {
+        out += "var ";
+        out += var->name.view();
+        child(var->type);
+        child(var->initializer);
+    } else if (auto* block = dynamic_cast<const BlockStmt*>(node)) {
+        out += "block";
+        for (auto& statement : block->statements) child(statement);
+    } else if (auto* branch = dynamic_cast<const IfStmt*>(node)) {
+        out += "if";
+        child(branch->condition);
+        child(branch->thenBranch);
+        child(branch->elseBranch);
+    } else if (auto* loop = dynamic_cast<const WhileStmt*>(node)) {
+        out += "while";
+        child(loop->condition);
+        child(loop->body);
+    } else if (auto* loop = dynamic_cast<const ForStmt*>(node)) {
+        out += "for";
+        child(loop->init);
+        child(loop->condition);
+        child(loop->increment);
+        child(loop->body);
+    } else if (auto* ret = dynamic_cast<const ReturnStmt*>(node)) {
+        out += "return";
+        child(ret->expression);
+    } else if (auto* statement = dynamic_cast<const ExpressionStmt*>(node)) {
+        out += "expr";
+        child(statement->expression);
+    } else if (auto* binary = dynamic_cast<const BinaryExpr*>(node)) {
+        out += binary->op;
+        child(binary->left);
+        child(binary->right);
+    } else if (auto* unary = dynamic_cast<const UnaryExpr*>(node)) {
+        out += unary->isPrefix ? "prefix " + unary->op : "postfix " + unary->op;
+        child(unary->operand);
+    } else if (auto* stream = dynamic_cast<const StreamExpr*>(node)) {
+        out += "stream " + stream->op;
+        for (auto& operand : stream->chain) child(operand);
+    } else if (auto* call = dynamic_cast<const FunctionCall*>(node)) {
+        out += "call";
+        child(call->callee);
+        for (auto& argument : call->arguments) child(argument);
+    } else if (auto* qualified = dynamic_cast<const QualifiedName*>(node)) {
+        out += "::";
+        child(qualified->left);
+        out += ' ' + qualified->right;
+    } else if (auto* identifier = dynamic_cast<const Identifier*>(node)) {
+        out += "id ";
+        out += identifier->name.view();
+    } else if (auto* literal = dynamic_cast<const Literal*>(node)) {
+        out += literal->kind + ' ' + literal->value;
+    } else {
+        out += "node " + std::to_string(static_cast<int>(node->type));
+    }
+    out += ')';
+}
+
+std::string describeTree(const ASTNode* node) {
+    std::string out;
+    describe(node, out);
+    return out;
+}
+
+// Top-level declarations of every kind parseParallel has to cut between,
+// including the two a '}' alone does not end: a struct with a declarator
+// and an if/else
+std::string generatedProgram(size_t blocks) {
+    std::string source;
+    for (size_t i = 0; i < blocks; ++i) {
+        std::string n = std::to_string(i);
+        source += "struct S" + n + " { int x; int y; } s" + n + ";\n";
+        source += "enum E" + n + " { A" + n + ", B" + n + " = " + n + " };\n";
+        source += "int g" + n + " = " + n + " * 2 + 1;\n";
+        source += "int f" + n + "() {\n"
+                  "    int a = g" + n + ";\n"
+                  "    for (a = 0; a < 10; a++) { g" + n + " = g" + n + " + a; }\n"
+                  "    while (a > 0) a = a - 1;\n"
+                  "    std::cout << \"f" + n + "\" << a << std::endl;\n"
+                  "    return helper(a, " + n + ");\n"
+                  "}\n";
+        source += "if (g" + n + " > 3) { g" + n + " = 1; } else { g" + n + " = 2; }\n";
+    }
+    return source;
+}
+
+} // unnamed namespace
+
+int runParserTests() {
+    int failures = 0;
+
+    // parseParallel() gives exactly the tree of parse()
+    std::string source = generatedProgram(1200);
+    Lexer lexer(source);
+    TokenBuffer tokens = lexer.tokenizePacked();
+    AstArena serialArena;
+    Parser serial(tokens, serialArena);
+    std::string expected = describeTree(serial.parse().get());
+    AstArena parallelArena;
+    Parser parallel(tokens, parallelArena);
+    std::string actual = describeTree(parallel.parseParallel(4).get());
+    if (tokens.size() < Parser::kParallelMinTokens || serial.hadError()) {
+        failures++;
+        std::cout << "FAIL: generated program has " << tokens.size() << " tokens and "
+                  << serial.diagnostics().size() << " errors\n";
+    }
+    if (actual != expected || parallel.hadError()) {
+        failures++;
+        size_t at = std::mismatch(actual.begin(), actual.end(), expected.begin(), expected.end()).first - actual.begin();
+        std::cout << "FAIL: parseParallel(4) differs from parse() at character " << at << "\n"
+                  << "  expected: " << expected.substr(at > 40 ? at - 40 : 0, 120) << "\n"
+                  << "  actual:   " << actual.substr(at > 40 ? at - 40 : 0, 120) << "\n";
+    }
+
+    // A diagnostic prints with the position of the offending token
+    std::string broken = "int main() {\n    int a = ;\n}\n";
+    Lexer brokenLexer(broken);
+    AstArena brokenArena;
+    Parser brokenParser(brokenLexer, brokenArena);
+    brokenParser.parse();
+    std::string message = brokenParser.hadError() ? formatDiagnostic(brokenParser.diagnostics()[0], brokenLexer) : "";
+    if (message != "<source>:2:13: Unexpected token in expression (found SEMICOLON)") {
+        failures++;
+        std::cout << "FAIL: diagnostic printed as '" << message << "'\n";
+    }
+
+    std::cout << "Parser tests: " << 2 - std::min(failures, 2) << "/2 passed\n";
+    return failures;
+}
+
+namespace {
+
+// Empty if both streams hold the same tokens, else where they first differ.
+// Works on std::vector<Token> and TokenBuffer alike.
+template <typename Expected, typename Actual>
+std::string firstTokenMismatch(const Expected& expected, const Actual& actual) {
+    for (size_t i = 0; i < std::min<size_t>(expected.size(), actual.size()); ++i) {
+        Token want = expected[i];
+        Token got = actual[i];
+        bool sameValue = want.is_float() == got.is_float() &&
+                         (want.is_float() ? want.float_value() == got.float_value()
+                                          : want.int_value() == got.int_value());
+        std::string differs;   // Fields toString() may not show
+        if (want.file() != got.file()) differs += " file";
+        if (want.symbol() != got.symbol()) differs += " symbol";
+        if (want.has_escape() != got.has_escape()) differs += " escape";
+        if (want.no_expand() != got.no_expand()) differs += " no_expand";
+        if (want.type() != got.type() || want.view() != got.view() || want.offset() != got.offset() ||
+            !sameValue || !differs.empty()) {
+            return "token " + std::to_string(i) + ": expected " + want.toString() + ", got " + got.toString() +
+                   (differs.empty() ? "" : " (differs in" + differs + ")");
+        }
+    }
+    if (expected.size() != actual.size()) {
+        return std::to_string(expected.size()) + " tokens expected, got " + std::to_string(actual.size());
+    }
+    return {};
+}
+
+// One edit: source[start, end) is replaced by replacement
+struct RelexCase {
+    const char* name;
+    const char* source;
+    size_t start;
+    size_t end;
+    const char* replacement;
+};
+
+const RelexCase kRelexCases[] = {
+    {"literal changed", "int a = 1;\nint b = 2;\n", 8, 9, "42"},
+    {"identifier extended", "int foo = 1;\nint b = foo;\n", 7, 7, "bar"},
+    {"token split", "int ab = 1;\n", 5, 5, " + "},
+    {"directive added", "#define X 1\nint a = X;\nint b = X;\n", 23, 23, "#undef X\n#define X 2\n"},
+    {"directive removed", "#define Y 3\nint c = Y;\nint d = Y;\n", 0, 12, ""},
+    {"directive edited", "#define Z 3\nint e = Z;\n", 10, 11, "4 + 5"},
+    {"conditional flipped", "#if 0\nint a;\n#endif\nint b;\n", 4, 5, "1"},
+    {"edit in macro arguments", "#define PAIR(a, b) a + b\nint x = PAIR(1, 2);\nint y;\n", 41, 42, "7"},
+    {"edit after an expansion", "#define ONE 1\nint x = ONE;\nint y = ONE;\n", 25, 26, " + ONE;"},
+    {"edit inside an expansion's name", "#define ONE 1\n#define ONCE 2\nint x = ONE;\n", 39, 39, "C"},
+};
+
+// Lex source, relex it after the edit and check the result against a fresh
+// lex of the edited text. Headers are looked up next to mainPath.
+std::string relexMismatch(const std::string& source, size_t start, size_t end, const std::string& replacement,
+                          IncludeResolver* includes = nullptr, const std::string& mainPath = {}) {
+    std::string edited = source.substr(0, start) + replacement + source.substr(end);
+
+    Lexer lexer(source);
+    lexer.setIncludeResolver(includes, mainPath);
+    std::vector<Token> previous = lexer.tokenize();
+    RelexResult result = lexer.relex(previous, edited, start, end, start + replacement.size());
+
+    Lexer fresh(edited);
+    fresh.setIncludeResolver(includes, mainPath);
+    std::string mismatch = firstTokenMismatch(fresh.tokenize(), result.tokens);
+    if (mismatch.empty() && result.tokens.size() - result.lastChanged != previous.size() - result.replacedEnd) {
+        mismatch = "carried-over tails differ in length";
+    }
+    return mismatch;
+}
+
+// Lexes to tokens that exercise every part of a cache entry: text at its
+// own offset, elsewhere in the source and synthesized (stringized), escapes,
+// and literal values. The lexer leaves values to later stages, so they are
+// filled in here, negative ones included.
+const char kCacheSource[] =
+    "#define STR(x) #x\n"
+    "#define TWICE(v) ((v) + (v))\n"
+    "const char* s = \"tab\\there\";\n"
+    "char c = '\\n';\n"
+    "double d = 2.5e3 + TWICE(0.5);\n"
+    "int n = 42 - 0x1F;\n"
+    "const char* name = STR(hello world);\n";
+
+void setLiteralValues(std::vector<Token>& tokens) {
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (tokens[i].type() == TokenType::INTEGER) tokens[i].set_int_value(static_cast<long long>(i) * 37 - 500);
+        if (tokens[i].type() == TokenType::FLOAT) tokens[i].set_float_value(static_cast<double>(i) + 0.25);
+    }
+}
+
+// Over Lexer::kParallelMinBytes of everything a chunk boundary can land in
+// or next to: directives and expansions the real lexer must redo, skipped
+// #if 0 text with stray quotes, line splices (one inside a string literal)
+// and block comments long enough that most boundaries fall inside one
+std::string parallelLexSource() {
+    std::string source;
+    for (size_t i = 0; source.size() < Lexer::kParallelMinBytes * 5 / 4; ++i) {
+        std::string n = std::to_string(i);
+        source += "#define V" + n + " (" + n + " + 1)\n"
+                  "int f" + n + "(int a) { return a * V" + n + " + MAX(a, " + n + "); }\n"
+                  "const char* s" + n + " = \"quote \\\" /* not a comment */ \\\\\";\n"
+                  "#if 0\n"
+                  "don't lex \" this\n"
+                  "#endif\n"
+                  "int long_name_" + n + " = \\\n"
+                  "    0x" + n + " + 'c';\n"
+                  "const char* t" + n + " = \"spliced \\\n"
+                  "string\";\n"
+                  "/* comment " + n + "\n";
+        for (int line = 0; line < 12; ++line) {
+            source += "   a line of commentary, with \"quotes\", 'ticks' and // slashes " + n + "\n";
+        }
+        source += "   #define NOT_A_DIRECTIVE */ double d" + n + " = 1.5;\n";
+    }
+    return "#define MAX(a, b) ((a) > (b) ? (a) : (b))\n" + source;
+}
+
+// Rewrite the single entry in directory through edit
+template <typename Edit>
+void editCacheEntry(const std::filesystem::path& directory, Edit edit) {
+    for (const auto& file : std::filesystem::directory_iterator(directory)) {
+        std::string bytes;
+        {
+            std::ifstream in(file.path(), std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        edit(bytes);
+        std::ofstream(file.path(), std::ios::binary | std::ios::trunc) << bytes;
+    }
+}
+
+} // unnamed namespace
+
+int runLexerTests() {
+    int failures = 0;
+    int total = 0;
+    auto check = [&failures, &total](const std::string& name, const std::string& mismatch) {
+        total++;
+        if (!mismatch.empty()) {
+            failures++;
+            std::cout << "FAIL: " << name << ": " << mismatch << "\n";
+        }
+    };
+
+    // relex() gives what tokenize() gives for the edited source
+    for (const RelexCase& test : kRelexCases) {
+        check(std::string("relex, ") + test.name,
+              relexMismatch(test.source, test.start, test.end, test.replacement));
+    }
+    namespace fs = std::filesystem;
+    fs::path header = fs::temp_directory_path() / "pbl_relex_test.hpp";
+    std::ofstream(header) << "int h = 1;\n#define H 7\n";
+    IncludeResolver includes;
+    std::string mainPath = (fs::temp_directory_path() / "pbl_relex_test.cpp").string();
+    std::string source = "#include \"pbl_relex_test.hpp\"\nint m = H;\n";
+    check("relex, stream with header tokens",
+          relexMismatch(source, source.size() - 3, source.size() - 2, "H + 1", &includes, mainPath));
+    {
+        // A TokenBuffer holds the same tokens as a std::vector<Token>, file ids included
+        Lexer vectorLexer(source);
+        vectorLexer.setIncludeResolver(&includes, mainPath);
+        Lexer packedLexer(source);
+        packedLexer.setIncludeResolver(&includes, mainPath);
+        check("TokenBuffer, tokens from a header",
+              firstTokenMismatch(vectorLexer.tokenize(), packedLexer.tokenizePacked()));
+    }
+    fs::remove(header);
+
+    // A TokenCache entry loads back token for token; anything stale or
+    // damaged is a miss
+    fs::path cacheDir = fs::temp_directory_path() / "pbl_token_cache_test";
+    fs::remove_all(cacheDir);
+    std::string_view cacheSource = kCacheSource;
+    Lexer cacheLexer(cacheSource);   // Owns the stringized text
+    uint64_t fingerprint = cacheLexer.macroFingerprint();
+    std::vector<Token> stored = cacheLexer.tokenize();
+    setLiteralValues(stored);
+    std::string entryBytes;
+    {
+        TokenCache cache(cacheDir.string());
+        std::vector<Token> loaded;
+        bool hit = cache.store(cacheSource, fingerprint, stored) && cache.load(cacheSource, fingerprint, loaded);
+        check("token cache, round trip", hit ? firstTokenMismatch(stored, loaded) : "entry not written or not read");
+        check("token cache, other macros", cache.load(cacheSource, fingerprint + 1, loaded) ? "hit" : "");
+        editCacheEntry(cacheDir, [&entryBytes](std::string& bytes) { entryBytes = bytes; });
+    }
+    {
+        // Header: magic[8], three u64 fields, then the lexer version varint
+        editCacheEntry(cacheDir, [](std::string& bytes) { bytes[32]++; });
+        TokenCache cache(cacheDir.string());
+        std::vector<Token> loaded;
+        check("token cache, stale lexer version", cache.load(cacheSource, fingerprint, loaded) ? "hit" : "");
+    }
+    for (size_t cut : {entryBytes.size() - 1, entryBytes.size() / 2, size_t(20)}) {
+        editCacheEntry(cacheDir, [&entryBytes, cut](std::string& bytes) { bytes = entryBytes.substr(0, cut); });
+        TokenCache cache(cacheDir.string());
+        std::vector<Token> loaded;
+        check("token cache, entry truncated to " + std::to_string(cut) + " bytes",
+              cache.load(cacheSource, fingerprint, loaded) ? "hit" : "");
+    }
+    fs::remove_all(cacheDir);
+
+    // tokenizeParallel() gives what tokenize() gives, wherever the chunks fall
+    std::string parallelSource = parallelLexSource();
+    Lexer serialLexer(parallelSource);
+    std::vector<Token> serialTokens = serialLexer.tokenize();
+    for (unsigned threads : {2u, 3u, 4u, 7u}) {
+        Lexer lexer(parallelSource);
+        check("tokenizeParallel(" + std::to_string(threads) + ")",
+              firstTokenMismatch(serialTokens, lexer.tokenizeParallel(threads)));
+    }
+
+    // tokenizePacked() gives what tokenize() gives; values, escapes and text
+    // outside the source survive the sparse columns
+    Lexer packedLexer(parallelSource);
+    check("TokenBuffer, generated source", firstTokenMismatch(serialTokens, packedLexer.tokenizePacked()));
+    TokenBuffer packed(cacheSource);
+    for (const Token& token : stored) packed.push_back(token);
+    check("TokenBuffer, literal values and synthesized text", firstTokenMismatch(stored, packed));
+
+    std::cout << "Lexer tests: " << total - failures << "/" << total << " passed\n";
+    return failures;
 }
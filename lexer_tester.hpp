@@ -2,7 +2,55 @@
 #define LEXER_TESTER_HPP
 
 #include <string>
+#include <string_view>
 
-void testLexer(const std::string& source);
+class TokenCache;
+class IncludeResolver;
+
+enum class DumpFormat {
+    Text,     // "Tokens generated: N", then one Token::toString() line per token
+    Ndjson,   // One JSON object per token per line, nothing else on stdout
+};
+
+struct LexerTestOptions {
+    bool parallel = false;                 // Lex with tokenizeParallel()
+    TokenCache* cache = nullptr;           // A hit skips lexing; a miss stores the tokens
+    IncludeResolver* includes = nullptr;   // Follow #include, relative to path first
+    std::string path;                      // Where source was read from
+    DumpFormat format = DumpFormat::Text;
+    bool stats = false;                    // Print lexing and dump throughput to stderr
+};
+
+// Dump the tokens of source to stdout. Output is formatted into a large
+// buffer and written in blocks, so the dump keeps up with the lexer.
+void testLexer(std::string_view source, const LexerTestOptions& options = {});
+
+// Lex source into a std::vector<Token> and into a TokenBuffer, check that
+// they hold the same tokens and report the memory each layout takes.
+void reportTokenMemory(std::string_view source, IncludeResolver* includes = nullptr,
+                       const std::string& path = {});
+
+// Parse source and print every diagnostic to stderr, one formatDiagnostic()
+// line each, then a summary. Returns the number of diagnostics.
+size_t testParser(std::string_view source, const LexerTestOptions& options = {});
+
+// Compare <cctype> classification against the char-class table over the
+// source bytes and report both throughputs in MB/s.
+void benchCharClass(std::string_view source, int iterations = 50);
+
+// Expand a fixed set of macro and conditional snippets and compare the
+// resulting token text. Prints each failure; returns how many failed.
+int runPreprocessorTests();
+
+// Check parseParallel() against parse() on a generated program above the
+// parallel threshold, and the printed form of a diagnostic. Prints each
+// failure; returns how many failed.
+int runParserTests();
+
+// Check relex() against a fresh tokenize() of the edited source, and
+// TokenCache entries (a hit gives back the stored tokens, a stale or
+// damaged entry is a miss), and tokenizeParallel() and tokenizePacked()
+// against tokenize(). Prints each failure; returns how many failed.
+int runLexerTests();
 
 #endif // LEXER_TESTER_HPP
@@ -0,0 +1,41 @@
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\line_index.hpp"
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\char_scan.hpp"
+#include <algorithm>
+
+LineIndex::LineIndex(std::string_view source)
+    : source_(source) {
+    lineStarts_.push_back(0);
+}
+
+void LineIndex::scanThrough(size_t offset) const {
+    const char* begin = source_.data();
+    const char* end = begin + source_.size();
+    while (scanned_ <= offset && scanned_ < source_.size()) {
+        const char* newline = scan::findNewline(begin + scanned_, end);
+        if (newline == end) {
+            scanned_ = source_.size();
+            break;
+        }
+        scanned_ = (newline - begin) + 1;
+        lineStarts_.push_back(static_cast<uint32_t>(scanned_));
+    }
+}
+
+size_t LineIndex::lineIndexOf(size_t offset) const {
+    scanThrough(offset);
+    auto it = std::upper_bound(lineStarts_.begin(), lineStarts_.end(), offset);
+    return static_cast<size_t>(it - lineStarts_.begin()) - 1;
+}
+
+int LineIndex::lineOf(size_t offset) const {
+    return static_cast<int>(lineIndexOf(offset)) + 1;
+}
+
+int LineIndex::columnOf(size_t offset) const {
+    return static_cast<int>(offset - lineStarts_[lineIndexOf(offset)]) + 1;
+}
+
+size_t LineIndex::lineCount() const {
+    scanThrough(source_.size());
+    return lineStarts_.size();
+}
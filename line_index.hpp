@@ -0,0 +1,35 @@
+#ifndef LINE_INDEX_HPP
+#define LINE_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Maps byte offsets in a source buffer to 1-based line/column numbers.
+//
+// The lexer only tracks byte offsets; positions are resolved here when a
+// diagnostic or the token dump actually needs them. Line starts are
+// discovered lazily with memchr, only as far as the furthest offset queried,
+// and then found by binary search. Not thread-safe (queries may grow the
+// table).
+class LineIndex {
+public:
+    explicit LineIndex(std::string_view source = {});
+
+    int lineOf(size_t offset) const;
+    int columnOf(size_t offset) const;
+
+    // Number of lines in the whole source (forces a full scan)
+    size_t lineCount() const;
+
+private:
+    std::string_view source_;
+    mutable std::vector<uint32_t> lineStarts_;   // Offset of the first byte of each line
+    mutable size_t scanned_ = 0;                 // Bytes already searched for '\n'
+
+    void scanThrough(size_t offset) const;       // Make sure the line holding offset is indexed
+    size_t lineIndexOf(size_t offset) const;     // 0-based line containing offset
+};
+
+#endif // LINE_INDEX_HPP
@@ -0,0 +1,69 @@
+#ifndef MACRO_FILTER_HPP
+#define MACRO_FILTER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Counting Bloom filter over the names of the defined macros.
+//
+// The lexer asks "is this identifier a macro?" for nearly every token, and
+// almost always the answer is no. The filter answers that from four bytes of
+// the name (first, middle, last, length) and two table probes, without
+// hashing the whole spelling, so only possible macros reach the hash map.
+// "No" is always right; "maybe" is wrong at a rate that grows with the
+// number of macros. Counters make #undef possible: a name's two counters go
+// up on define and down on undef. A counter that saturates is never
+// decremented again, which costs accuracy but never a false "no".
+class MacroFilter {
+public:
+    static constexpr size_t kSlotBits = 12;
+    static constexpr size_t kSlots = size_t(1) << kSlotBits;   // 4 KiB of counters
+
+    bool mayContain(std::string_view name) const {
+        uint32_t h = hash(name);
+        return counts_[probe1(h)] != 0 && counts_[probe2(h)] != 0;
+    }
+
+    void add(std::string_view name) {
+        uint32_t h = hash(name);
+        increment(probe1(h));
+        increment(probe2(h));
+    }
+
+    // name must have been added (and not removed since)
+    void remove(std::string_view name) {
+        uint32_t h = hash(name);
+        decrement(probe1(h));
+        decrement(probe2(h));
+    }
+
+    void clear() { counts_.fill(0); }
+
+private:
+    std::array<uint8_t, kSlots> counts_{};
+
+    static uint32_t hash(std::string_view name) {
+        size_t n = name.size();
+        if (n == 0) return 0;
+        uint32_t key = static_cast<uint32_t>(static_cast<unsigned char>(name[0])) |
+                       static_cast<uint32_t>(static_cast<unsigned char>(name[n / 2])) << 8 |
+                       static_cast<uint32_t>(static_cast<unsigned char>(name[n - 1])) << 16 |
+                       static_cast<uint32_t>(n) << 24;
+        return key * 0x9E3779B1u;   // Fibonacci hashing: the high bits mix every input byte
+    }
+
+    static size_t probe1(uint32_t h) { return h >> (32 - kSlotBits); }
+    static size_t probe2(uint32_t h) { return (h >> (32 - 2 * kSlotBits)) & (kSlots - 1); }
+
+    void increment(size_t slot) {
+        if (counts_[slot] != UINT8_MAX) counts_[slot]++;
+    }
+
+    void decrement(size_t slot) {
+        if (counts_[slot] != UINT8_MAX) counts_[slot]--;   // Saturated: stays set for good
+    }
+};
+
+#endif // MACRO_FILTER_HPP
@@ -0,0 +1,277 @@
+#ifndef PARSE_DIAGNOSTICS_HPP
+#define PARSE_DIAGNOSTICS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\tokens.hpp"
+
+// Every error the parser can report. Call sites pass one of these instead
+// of a message string, so a successful check builds nothing; the text is
+// only looked up when a diagnostic is printed.
+enum class ParseDiag : uint8_t {
+    UnexpectedTokenInExpression,
+    ExpectedClassName,
+    ExpectedLBraceAfterClassName,
+    ExpectedColonAfterPublic,
+    ExpectedColonAfterPrivate,
+    ExpectedColonAfterProtected,
+    ExpectedRBraceAfterClassBody,
+    ExpectedStruct,
+    ExpectedStructName,
+    ExpectedLBraceAfterStructName,
+    ExpectedRBraceAfterStructBody,
+    ExpectedSemicolonAfterStructDeclaration,
+    ExpectedVariableName,
+    ExpectedSemicolonAfterVariableDeclaration,
+    ExpectedFunctionName,
+    ExpectedLParenAfterFunctionName,
+    ExpectedRParenAfterParameters,
+    ExpectedLBraceToStartBlock,
+    ExpectedRBraceToEndBlock,
+    ExpectedSemicolonAfterExpression,
+    ExpectedLessAfterStaticCast,
+    ExpectedGreaterAfterType,
+    ExpectedLParenAfterGreater,
+    ExpectedRParen,
+    ExpectedLessAfterDynamicCast,
+    ExpectedLessAfterConstCast,
+    ExpectedLessAfterReinterpretCast,
+    ExpectedRParenAfterNewArguments,
+    ExpectedLParenAfterLambdaCapture,
+    ExpectedParameterName,
+    ExpectedRParenAfterLambdaParams,
+    ExpectedCatch,
+    ExpectedLParenAfterCatch,
+    ExpectedExceptionVariableName,
+    ExpectedRParenAfterCatchParameter,
+    ExpectedTry,
+    ExpectedThrow,
+    ExpectedSemicolonAfterThrowStatement,
+    ExpectedBreak,
+    ExpectedSemicolonAfterBreak,
+    ExpectedContinue,
+    ExpectedSemicolonAfterContinue,
+    ExpectedGoto,
+    ExpectedLabelAfterGoto,
+    ExpectedSemicolonAfterGotoStatement,
+    ExpectedElse,
+    ExpectedSwitch,
+    ExpectedLParenAfterSwitch,
+    ExpectedRParenAfterSwitchCondition,
+    ExpectedLBraceAfterSwitch,
+    ExpectedRBraceAfterSwitchBody,
+    ExpectedCase,
+    ExpectedColonAfterCaseValue,
+    ExpectedDefault,
+    ExpectedColonAfterDefault,
+    ExpectedDo,
+    ExpectedWhileAfterDoBody,
+    ExpectedLParenAfterWhile,
+    ExpectedRParenAfterDoWhileCondition,
+    ExpectedSemicolonAfterDoWhile,
+    ExpectedUnion,
+    ExpectedUnionName,
+    ExpectedLBraceAfterUnionName,
+    ExpectedSemicolonAfterUnionMember,
+    ExpectedRBraceAfterUnionBody,
+    ExpectedSemicolonAfterUnionDeclaration,
+    ExpectedEnum,
+    ExpectedEnumName,
+    ExpectedLBraceAfterEnumName,
+    ExpectedEnumeratorName,
+    ExpectedEnumeratorValue,
+    ExpectedRBraceAfterEnumBody,
+    ExpectedSemicolonAfterEnumDeclaration,
+    ExpectedTypedef,
+    ExpectedTypedefAliasName,
+    ExpectedSemicolonAfterTypedef,
+    ExpectedLessForTemplateType,
+    ExpectedGreaterAfterTemplateArguments,
+    ExpectedRParenAfterArguments,
+    ExpectedWhile,
+    ExpectedRParenAfterCondition,
+    ExpectedFor,
+    ExpectedLParenAfterFor,
+    ExpectedSemicolonAfterForInit,
+    ExpectedSemicolonAfterForCondition,
+    ExpectedRParenAfterForIncrement,
+    ExpectedIf,
+    ExpectedLParenAfterIf,
+    ExpectedReturn,
+    ExpectedSemicolonAfterReturn,
+    ExpectedNamespace,
+    ExpectedNamespaceName,
+    ExpectedLBraceAfterNamespaceName,
+    ExpectedRBraceAfterNamespaceBody,
+    ExpectedUsing,
+    ExpectedIdentifierAfterUsing,
+    ExpectedSemicolonAfterUsingDirective,
+    ExpectedColonInTernaryExpression,
+    ExpectedRBracketAfterArrayIndex,
+    ExpectedMemberNameAfterDotOrArrow,
+    ExpectedIdentifierAfterScope,
+    ExpectedTypeName,
+    ExpectedHeaderAfterInclude,
+    ExpectedMacroNameAfterDefine,
+    ExpectedMacroNameAfterUndef,
+    ExpectedMacroNameAfterIfdef,
+    ExpectedMacroNameAfterIfndef
+};
+
+struct ParseDiagEntry {
+    ParseDiag id;
+    std::string_view message;
+};
+
+inline constexpr ParseDiagEntry kParseDiagMessages[] = {
+    {ParseDiag::UnexpectedTokenInExpression, "Unexpected token in expression"},
+    {ParseDiag::ExpectedClassName, "Expected class name"},
+    {ParseDiag::ExpectedLBraceAfterClassName, "Expected '{' after class name"},
+    {ParseDiag::ExpectedColonAfterPublic, "Expected ':' after 'public'"},
+    {ParseDiag::ExpectedColonAfterPrivate, "Expected ':' after 'private'"},
+    {ParseDiag::ExpectedColonAfterProtected, "Expected ':' after 'protected'"},
+    {ParseDiag::ExpectedRBraceAfterClassBody, "Expected '}' after class body"},
+    {ParseDiag::ExpectedStruct, "Expected 'struct'"},
+    {ParseDiag::ExpectedStructName, "Expected struct name"},
+    {ParseDiag::ExpectedLBraceAfterStructName, "Expected '{' after struct name"},
+    {ParseDiag::ExpectedRBraceAfterStructBody, "Expected '}' after struct body"},
+    {ParseDiag::ExpectedSemicolonAfterStructDeclaration, "Expected ';' after struct declaration"},
+    {ParseDiag::ExpectedVariableName, "Expected variable name"},
+    {ParseDiag::ExpectedSemicolonAfterVariableDeclaration, "Expected ';' after variable declaration"},
+    {ParseDiag::ExpectedFunctionName, "Expected function name"},
+    {ParseDiag::ExpectedLParenAfterFunctionName, "Expected '(' after function name"},
+    {ParseDiag::ExpectedRParenAfterParameters, "Expected ')' after parameters"},
+    {ParseDiag::ExpectedLBraceToStartBlock, "Expected '{' to start block"},
+    {ParseDiag::ExpectedRBraceToEndBlock, "Expected '}' to end block"},
+    {ParseDiag::ExpectedSemicolonAfterExpression, "Expected ';' after expression"},
+    {ParseDiag::ExpectedLessAfterStaticCast, "Expected '<' after static_cast"},
+    {ParseDiag::ExpectedGreaterAfterType, "Expected '>' after type"},
+    {ParseDiag::ExpectedLParenAfterGreater, "Expected '(' after '>'"},
+    {ParseDiag::ExpectedRParen, "Expected ')'"},
+    {ParseDiag::ExpectedLessAfterDynamicCast, "Expected '<' after dynamic_cast"},
+    {ParseDiag::ExpectedLessAfterConstCast, "Expected '<' after const_cast"},
+    {ParseDiag::ExpectedLessAfterReinterpretCast, "Expected '<' after reinterpret_cast"},
+    {ParseDiag::ExpectedRParenAfterNewArguments, "Expected ')' after new arguments"},
+    {ParseDiag::ExpectedLParenAfterLambdaCapture, "Expected '(' after lambda capture"},
+    {ParseDiag::ExpectedParameterName, "Expected parameter name"},
+    {ParseDiag::ExpectedRParenAfterLambdaParams, "Expected ')' after lambda params"},
+    {ParseDiag::ExpectedCatch, "Expected 'catch'"},
+    {ParseDiag::ExpectedLParenAfterCatch, "Expected '(' after 'catch'"},
+    {ParseDiag::ExpectedExceptionVariableName, "Expected exception variable name"},
+    {ParseDiag::ExpectedRParenAfterCatchParameter, "Expected ')' after catch parameter"},
+    {ParseDiag::ExpectedTry, "Expected 'try'"},
+    {ParseDiag::ExpectedThrow, "Expected 'throw'"},
+    {ParseDiag::ExpectedSemicolonAfterThrowStatement, "Expected ';' after throw statement"},
+    {ParseDiag::ExpectedBreak, "Expected 'break'"},
+    {ParseDiag::ExpectedSemicolonAfterBreak, "Expected ';' after break"},
+    {ParseDiag::ExpectedContinue, "Expected 'continue'"},
+    {ParseDiag::ExpectedSemicolonAfterContinue, "Expected ';' after continue"},
+    {ParseDiag::ExpectedGoto, "Expected 'goto'"},
+    {ParseDiag::ExpectedLabelAfterGoto, "Expected label after 'goto'"},
+    {ParseDiag::ExpectedSemicolonAfterGotoStatement, "Expected ';' after goto statement"},
+    {ParseDiag::ExpectedElse, "Expected 'else'"},
+    {ParseDiag::ExpectedSwitch, "Expected 'switch'"},
+    {ParseDiag::ExpectedLParenAfterSwitch, "Expected '(' after 'switch'"},
+    {ParseDiag::ExpectedRParenAfterSwitchCondition, "Expected ')' after switch condition"},
+    {ParseDiag::ExpectedLBraceAfterSwitch, "Expected '{' after switch"},
+    {ParseDiag::ExpectedRBraceAfterSwitchBody, "Expected '}' after switch body"},
+    {ParseDiag::ExpectedCase, "Expected 'case'"},
+    {ParseDiag::ExpectedColonAfterCaseValue, "Expected ':' after case value"},
+    {ParseDiag::ExpectedDefault, "Expected 'default'"},
+    {ParseDiag::ExpectedColonAfterDefault, "Expected ':' after default"},
+    {ParseDiag::ExpectedDo, "Expected 'do'"},
+    {ParseDiag::ExpectedWhileAfterDoBody, "Expected 'while' after do body"},
+    {ParseDiag::ExpectedLParenAfterWhile, "Expected '(' after 'while'"},
+    {ParseDiag::ExpectedRParenAfterDoWhileCondition, "Expected ')' after do-while condition"},
+    {ParseDiag::ExpectedSemicolonAfterDoWhile, "Expected ';' after do-while"},
+    {ParseDiag::ExpectedUnion, "Expected 'union'"},
+    {ParseDiag::ExpectedUnionName, "Expected union name"},
+    {ParseDiag::ExpectedLBraceAfterUnionName, "Expected '{' after union name"},
+    {ParseDiag::ExpectedSemicolonAfterUnionMember, "Expected ';' after union member"},
+    {ParseDiag::ExpectedRBraceAfterUnionBody, "Expected '}' after union body"},
+    {ParseDiag::ExpectedSemicolonAfterUnionDeclaration, "Expected ';' after union declaration"},
+    {ParseDiag::ExpectedEnum, "Expected 'enum'"},
+    {ParseDiag::ExpectedEnumName, "Expected enum name"},
+    {ParseDiag::ExpectedLBraceAfterEnumName, "Expected '{' after enum name"},
+    {ParseDiag::ExpectedEnumeratorName, "Expected enumerator name"},
+    {ParseDiag::ExpectedEnumeratorValue, "Expected integer value after '='"},
+    {ParseDiag::ExpectedRBraceAfterEnumBody, "Expected '}' after enum body"},
+    {ParseDiag::ExpectedSemicolonAfterEnumDeclaration, "Expected ';' after enum declaration"},
+    {ParseDiag::ExpectedTypedef, "Expected 'typedef'"},
+    {ParseDiag::ExpectedTypedefAliasName, "Expected typedef alias name"},
+    {ParseDiag::ExpectedSemicolonAfterTypedef, "Expected ';' after typedef"},
+    {ParseDiag::ExpectedLessForTemplateType, "Expected '<' for template type"},
+    {ParseDiag::ExpectedGreaterAfterTemplateArguments, "Expected '>' after template arguments"},
+    {ParseDiag::ExpectedRParenAfterArguments, "Expected ')' after arguments"},
+    {ParseDiag::ExpectedWhile, "Expected 'while'"},
+    {ParseDiag::ExpectedRParenAfterCondition, "Expected ')' after condition"},
+    {ParseDiag::ExpectedFor, "Expected 'for'"},
+    {ParseDiag::ExpectedLParenAfterFor, "Expected '(' after 'for'"},
+    {ParseDiag::ExpectedSemicolonAfterForInit, "Expected ';' after for-init"},
+    {ParseDiag::ExpectedSemicolonAfterForCondition, "Expected ';' after for-condition"},
+    {ParseDiag::ExpectedRParenAfterForIncrement, "Expected ')' after for-increment"},
+    {ParseDiag::ExpectedIf, "Expected 'if'"},
+    {ParseDiag::ExpectedLParenAfterIf, "Expected '(' after 'if'"},
+    {ParseDiag::ExpectedReturn, "Expected 'return'"},
+    {ParseDiag::ExpectedSemicolonAfterReturn, "Expected ';' after return"},
+    {ParseDiag::ExpectedNamespace, "Expected 'namespace'"},
+    {ParseDiag::ExpectedNamespaceName, "Expected namespace name"},
+    {ParseDiag::ExpectedLBraceAfterNamespaceName, "Expected '{' after namespace name"},
+    {ParseDiag::ExpectedRBraceAfterNamespaceBody, "Expected '}' after namespace body"},
+    {ParseDiag::ExpectedUsing, "Expected 'using'"},
+    {ParseDiag::ExpectedIdentifierAfterUsing, "Expected identifier after 'using'"},
+    {ParseDiag::ExpectedSemicolonAfterUsingDirective, "Expected ';' after using directive"},
+    {ParseDiag::ExpectedColonInTernaryExpression, "Expected ':' in ternary expression"},
+    {ParseDiag::ExpectedRBracketAfterArrayIndex, "Expected ']' after array index"},
+    {ParseDiag::ExpectedMemberNameAfterDotOrArrow, "Expected member name after '.' or '->'"},
+    {ParseDiag::ExpectedIdentifierAfterScope, "Expected identifier after '::'"},
+    {ParseDiag::ExpectedTypeName, "Expected type name"},
+    {ParseDiag::ExpectedHeaderAfterInclude, "Expected header after #include"},
+    {ParseDiag::ExpectedMacroNameAfterDefine, "Expected macro name after #define"},
+    {ParseDiag::ExpectedMacroNameAfterUndef, "Expected macro name after #undef"},
+    {ParseDiag::ExpectedMacroNameAfterIfdef, "Expected macro name after #ifdef"},
+    {ParseDiag::ExpectedMacroNameAfterIfndef, "Expected macro name after #ifndef"}
+};
+
+inline constexpr size_t kParseDiagCount = static_cast<size_t>(ParseDiag::ExpectedMacroNameAfterIfndef) + 1;
+
+namespace parse_diag_detail {
+
+constexpr std::array<std::string_view, kParseDiagCount> buildMessageTable() {
+    std::array<std::string_view, kParseDiagCount> table{};
+    for (const ParseDiagEntry& entry : kParseDiagMessages) {
+        table[static_cast<size_t>(entry.id)] = entry.message;
+    }
+    return table;
+}
+
+inline constexpr std::array<std::string_view, kParseDiagCount> kTable = buildMessageTable();
+
+constexpr bool everyDiagDescribedOnce() {
+    if (sizeof(kParseDiagMessages) / sizeof(kParseDiagMessages[0]) != kParseDiagCount) return false;
+    for (std::string_view message : kTable) {
+        if (message.empty()) return false;
+    }
+    return true;
+}
+
+static_assert(everyDiagDescribedOnce(), "kParseDiagMessages must describe every ParseDiag exactly once");
+
+} // namespace parse_diag_detail
+
+constexpr std::string_view parseDiagMessage(ParseDiag id) {
+    return parse_diag_detail::kTable[static_cast<size_t>(id)];
+}
+
+// One reported error: what was expected, what was found instead, and where
+// (the offending token's byte offset in its file)
+struct Diagnostic {
+    ParseDiag id;
+    TokenType found;
+    uint16_t file;
+    uint32_t offset;
+};
+
+#endif // PARSE_DIAGNOSTICS_HPP
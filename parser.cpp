@@ -1,20 +1,146 @@
 #include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\parser.hpp"
-#include <stdexcept>
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\token_names.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <iostream>
+#include <thread>
+
+// --- Operator binding powers ---
+//
+// One precedence-climbing loop over a binding-power table replaces a
+// function per precedence level. Each binary operator binds its left
+// operand with power left and parses its right operand at power right:
+// left-associative operators use right = left + 1, right-associative ones
+// (assignment, ?:) right = left. A leaf costs two calls, whatever the
+// depth of the C++ operator table.
+namespace {
+
+struct BindingPower {
+    uint8_t left;    // 0: the token does not continue an expression
+    uint8_t right;
+};
+
+constexpr int kCommaPower = 2;
+constexpr int kAssignmentPower = 4;      // Also ?:
+constexpr int kShiftPower = 22;
+constexpr int kAdditivePower = 24;
+constexpr int kPrefixPower = 30;         // Above every binary operator
+
+constexpr std::array<BindingPower, kTokenTypeCount> buildBindingPowers() {
+    std::array<BindingPower, kTokenTypeCount> table{};
+    auto leftAssoc = [&table](TokenType type, int power) {
+        table[static_cast<size_t>(type)] = BindingPower{static_cast<uint8_t>(power), static_cast<uint8_t>(power + 1)};
+    };
+    auto rightAssoc = [&table](TokenType type, int power) {
+        table[static_cast<size_t>(type)] = BindingPower{static_cast<uint8_t>(power), static_cast<uint8_t>(power)};
+    };
+
+    leftAssoc(TokenType::COMMA, kCommaPower);
+    for (TokenType type : {TokenType::EQUAL, TokenType::PLUS_EQUAL, TokenType::MINUS_EQUAL,
+                           TokenType::STAR_EQUAL, TokenType::SLASH_EQUAL, TokenType::PERCENT_EQUAL,
+                           TokenType::LEFT_SHIFT_EQUAL, TokenType::RIGHT_SHIFT_EQUAL,
+                           TokenType::AND_EQUAL, TokenType::XOR_EQUAL, TokenType::OR_EQUAL,
+                           TokenType::QUESTION}) {
+        rightAssoc(type, kAssignmentPower);
+    }
+    leftAssoc(TokenType::OR_OR, 6);
+    leftAssoc(TokenType::AND_AND, 8);
+    leftAssoc(TokenType::PIPE, 10);
+    leftAssoc(TokenType::CARET, 12);
+    leftAssoc(TokenType::AMPERSAND, 14);
+    leftAssoc(TokenType::EQUAL_EQUAL, 16);
+    leftAssoc(TokenType::NOT_EQUAL, 16);
+    for (TokenType type : {TokenType::LESS, TokenType::LESS_EQUAL, TokenType::GREATER, TokenType::GREATER_EQUAL}) {
+        leftAssoc(type, 18);
+    }
+    leftAssoc(TokenType::SPACESHIP, 20);
+    leftAssoc(TokenType::LESS_LESS, kShiftPower);
+    leftAssoc(TokenType::GREATER_GREATER, kShiftPower);
+    leftAssoc(TokenType::PLUS, kAdditivePower);
+    leftAssoc(TokenType::MINUS, kAdditivePower);
+    leftAssoc(TokenType::STAR, 26);
+    leftAssoc(TokenType::SLASH, 26);
+    leftAssoc(TokenType::PERCENT, 26);
+    leftAssoc(TokenType::DOT_STAR, 28);
+    leftAssoc(TokenType::ARROW_STAR, 28);
+    return table;
+}
+
+constexpr std::array<BindingPower, kTokenTypeCount> kBindingPowers = buildBindingPowers();
+
+static_assert(kBindingPowers[static_cast<size_t>(TokenType::ARROW_STAR)].right < kPrefixPower,
+              "prefix operators must bind tighter than every binary operator");
+
+bool isPrefixOperator(TokenType type) {
+    switch (type) {
+        case TokenType::EXCLAIM: case TokenType::TILDE:
+        case TokenType::MINUS: case TokenType::PLUS:
+        case TokenType::INCREMENT: case TokenType::DECREMENT:
+        case TokenType::STAR: case TokenType::AMPERSAND:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// cin, cout, cerr and clog lex as keywords of their own
+bool isStreamToken(TokenType type) {
+    return type == TokenType::CIN || type == TokenType::COUT ||
+           type == TokenType::CERR || type == TokenType::CLIN;
+}
+
+bool isStreamName(std::string_view name) {
+    return name == "cin" || name == "cout" || name == "cerr" || name == "clog";
+}
+
+// A standard stream, plain or qualified (std::cout): a "<<" or ">>" chain
+// after it is a StreamExpr rather than nested shifts
+bool isStreamObject(const ASTNode* node) {
+    if (auto* id = dynamic_cast<const Identifier*>(node)) return isStreamName(id->name.view());
+    if (auto* qualified = dynamic_cast<const QualifiedName*>(node)) return isStreamName(qualified->right);
+    return false;
+}
+
+} // unnamed namespace
 
 // --- Constructor ---
-Parser::Parser(Lexer& lexer)
-    : lexer(lexer) {
+Parser::Parser(Lexer& lexer, AstArena& arena)
+    : arena(arena), lexer(&lexer) {
+    advance();
+}
+
+Parser::Parser(const TokenBuffer& tokens, AstArena& arena)
+    : Parser(tokens, arena, 0, tokens.empty() ? 0 : tokens.size() - 1) {}
+
+Parser::Parser(const TokenBuffer& tokens, AstArena& arena, size_t begin, size_t end)
+    : arena(arena), tokens(&tokens), nextIndex(begin), endIndex(end) {
     advance();
 }
 
 // --- Token helpers ---
 void Parser::advance() {
     prev = current;
-    auto tokenPtr = lexer.tokenize();
-    if (!tokenPtr.empty()) {
-        current = *tokenPtr.front();
+    consumed++;
+    if (lexer) {
+        current = lexer->nextToken();
     }
+    else if (nextIndex < endIndex) {
+        current = (*tokens)[nextIndex++];
+    }
+    else if (nextIndex == endIndex) {
+        // End of the range (for a range of parseParallel, where the next one starts)
+        bool inBuffer = endIndex < tokens->size();
+        current = Token(TokenType::END_OF_FILE, std::string_view(), inBuffer ? tokens->offset(endIndex) : 0);
+        if (inBuffer) current.set_file(tokens->file(endIndex));
+        nextIndex++;   // Past the end, END_OF_FILE repeats
+    }
+}
+
+TokenType Parser::peekType(size_t k) {
+    if (lexer) return lexer->peekToken(k).type();
+    size_t index = nextIndex + k;
+    return index < endIndex ? tokens->type(index) : TokenType::END_OF_FILE;
 }
 
 bool Parser::match(TokenType type) {
@@ -25,6 +151,17 @@ bool Parser::match(TokenType type) {
     return false;
 }
 
+// Identifiers arrive interned by the lexer; keywords used as names do not
+Symbol Parser::symbolOf(const Token& token) {
+    return token.symbol().empty() ? internName(token.view()) : token.symbol();
+}
+
+// Only parseParallel's workers intern concurrently; everyone else keeps the
+// interner's unlocked path
+Symbol Parser::internName(std::string_view spelling) {
+    return concurrent ? SymbolInterner::global().internShared(spelling) : intern(spelling);
+}
+
 bool Parser::check(TokenType type) {
     return current.type() == type;
 }
@@ -37,52 +174,259 @@ Token Parser::previous() {
     return prev;
 }
 
-bool Parser::expect(TokenType type, const std::string& errMsg) {
+bool Parser::expect(TokenType type, ParseDiag diag) {
     if (current.type() == type) {
         advance();
         return true;
     }
-    throw std::runtime_error(errMsg);
+    report(diag);
+    return false;
+}
+
+// --- Error recovery ---
+// The first error puts the parser in panic mode: later errors are dropped
+// (they are usually fallout from the first) until the enclosing statement
+// list calls synchronize, which skips to the end of the broken statement.
+void Parser::report(ParseDiag diag) {
+    if (panicMode) return;
+    panicMode = true;
+    errorAt = consumed;
+    errors.push_back(Diagnostic{diag, current.type(), current.file(), current.offset()});
+}
+
+void Parser::synchronize() {
+    if (!panicMode) return;
+    panicMode = false;
+    if (prev.type() == TokenType::SEMICOLON && consumed > errorAt) {
+        return;   // The broken statement was closed after the error
+    }
+
+    int depth = 0;   // Braces opened while skipping
+    while (!isAtEnd()) {
+        if (check(TokenType::LEFT_BRACE)) {
+            depth++;
+        } else if (check(TokenType::RIGHT_BRACE)) {
+            if (depth == 0) return;   // Closes the enclosing block: leave it to the block
+            if (--depth == 0) { advance(); return; }
+        } else if (check(TokenType::SEMICOLON) && depth == 0) {
+            advance();
+            return;
+        }
+        advance();
+    }
+}
+
+// Call after each element of a statement or member list, with the value
+// of consumed when the element started. Besides recovering from an error,
+// it steps over a token the element could not use, so the list always
+// moves on.
+void Parser::recover(size_t start) {
+    synchronize();
+    if (consumed == start && !isAtEnd()) advance();
 }
 
 // --- Top-level parse ---
-std::unique_ptr<ASTNode> Parser::parse() {
+ArenaPtr<ASTNode> Parser::parse() {
+    started = true;
     return parseProgram();
 }
 
-std::unique_ptr<Program> Parser::parseProgram() {
-    auto program = std::make_unique<Program>();
+ArenaPtr<Program> Parser::parseProgram() {
+    auto program = arena.make<Program>();
     while (current.type() != TokenType::END_OF_FILE) {
+        size_t start = consumed;
         auto decl = parseDeclaration();
         if (decl) program->globals.push_back(std::move(decl));
+        recover(start);
+        if (check(TokenType::RIGHT_BRACE)) advance();   // Stray '}' (already reported): nothing to close
+    }
+    return program;
+}
+
+// === Parallel parsing ===
+//
+// A prescan over the type column matches braces, parentheses and brackets
+// and cuts the buffer after each top-level ';' or '}' at which the serial
+// parser is sure to have finished a declaration. Runs of whole declarations
+// become tasks; worker threads claim the next unparsed task from a shared
+// counter, so a thread that drew small functions simply takes more of them.
+// Each worker owns a Parser, which sees END_OF_FILE at the end of its range,
+// and an AstArena, which this parser's arena adopts once every worker is done.
+// The declarations are stitched into one Program in source order. If any
+// range reports an error, the input is parsed again serially, so the tree
+// and diagnostics are always exactly those of parse().
+
+namespace {
+
+constexpr size_t kTaskMinTokens = 8192;   // Smaller runs of declarations are merged
+
+// Tokens that may start a declaration but can never continue the one before
+// a '}' that closed a function or namespace body (unlike else, catch, while
+// of a do-while, ';' or an operator)
+bool startsDeclaration(TokenType type) {
+    switch (type) {
+        case TokenType::IDENTIFIER:
+        case TokenType::INT: case TokenType::VOID: case TokenType::CHAR:
+        case TokenType::FLOAT_TYPE: case TokenType::DOUBLE: case TokenType::BOOL:
+        case TokenType::UNSIGNED: case TokenType::SIGNED: case TokenType::SHORT: case TokenType::LONG:
+        case TokenType::CONST: case TokenType::STATIC: case TokenType::EXTERN:
+        case TokenType::INLINE: case TokenType::VIRTUAL:
+        case TokenType::CLASS: case TokenType::STRUCT: case TokenType::ENUM: case TokenType::UNION:
+        case TokenType::NAMESPACE: case TokenType::TYPEDEF: case TokenType::USING: case TokenType::TEMPLATE:
+        case TokenType::IF: case TokenType::FOR: case TokenType::SWITCH: case TokenType::DO:
+        case TokenType::TRY: case TokenType::RETURN:
+        case TokenType::PREPROCESSOR_INCLUDE: case TokenType::PREPROCESSOR_DEFINE:
+        case TokenType::PREPROCESSOR_IFDEF: case TokenType::PREPROCESSOR_IFNDEF:
+        case TokenType::PREPROCESSOR_IF: case TokenType::PREPROCESSOR_ELIF:
+        case TokenType::PREPROCESSOR_ELSE: case TokenType::PREPROCESSOR_ENDIF:
+        case TokenType::PREPROCESSOR_UNDEF: case TokenType::PREPROCESSOR_PRAGMA:
+        case TokenType::PREPROCESSOR_UNKNOWN:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Task boundaries over tokens [0, end): starts of consecutive ranges, then end.
+// A top-level '}' only ends the declaration when it closed a function or
+// namespace body; after a class, struct, union or enum body declarators may
+// follow ("struct S { ... } s;"), so the cut waits for the ';'.
+std::vector<size_t> declarationRanges(const TokenBuffer& tokens, size_t end) {
+    const uint8_t* types = tokens.types();
+    std::vector<size_t> bounds{0};
+    size_t braces = 0;
+    size_t groups = 0;       // Open parentheses and brackets
+    bool typeKey = false;    // class/struct/union/enum since the last top-level ';' or '}', no '(' after it
+    bool typeBody = false;   // The open top-level brace is a type's body
+    for (size_t i = 0; i < end; ++i) {
+        TokenType type = static_cast<TokenType>(types[i]);
+        TokenType next = i + 1 < end ? static_cast<TokenType>(types[i + 1]) : TokenType::END_OF_FILE;
+        bool topLevel = braces == 0 && groups == 0;
+        bool cut = false;
+        switch (type) {
+            case TokenType::CLASS: case TokenType::STRUCT: case TokenType::UNION: case TokenType::ENUM:
+                if (topLevel) typeKey = true;
+                break;
+            case TokenType::LEFT_BRACE:
+                if (topLevel) typeBody = typeKey;
+                braces++;
+                break;
+            case TokenType::LEFT_PAREN:
+                if (topLevel) typeKey = false;   // "struct S* make() {" is a function body
+                groups++;
+                break;
+            case TokenType::LEFT_BRACKET: groups++; break;
+            case TokenType::RIGHT_PAREN: case TokenType::RIGHT_BRACKET: if (groups > 0) groups--; break;
+            case TokenType::RIGHT_BRACE:
+                if (braces > 0) braces--;
+                if (braces == 0 && groups == 0) {
+                    typeKey = false;
+                    cut = !typeBody && startsDeclaration(next);
+                }
+                break;
+            case TokenType::SEMICOLON:
+                if (topLevel) typeKey = false;
+                cut = topLevel && next != TokenType::ELSE && next != TokenType::WHILE;
+                break;
+            default: break;
+        }
+        if (cut && i + 1 < end && i + 1 - bounds.back() >= kTaskMinTokens) {
+            bounds.push_back(i + 1);
+        }
+    }
+    if (bounds.size() > 1 && end - bounds.back() < kTaskMinTokens / 2) {
+        bounds.pop_back();   // Fold a short tail into the previous range
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+} // unnamed namespace
+
+ArenaPtr<ASTNode> Parser::parseParallel(unsigned threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (threadCount < 2 || !tokens || tokens->size() < kParallelMinTokens || started) {
+        return parse();
+    }
+    started = true;
+
+    std::vector<size_t> bounds = declarationRanges(*tokens, endIndex);
+    size_t tasks = bounds.size() - 1;
+    if (tasks < 2) {
+        return parse();
+    }
+
+    struct ParsedRange {
+        ArenaPtr<Program> program;
+        std::vector<Diagnostic> errors;
+    };
+    std::vector<ParsedRange> results(tasks);
+    size_t workerCount = std::min<size_t>(threadCount, tasks);
+    std::vector<AstArena> arenas(workerCount);
+    std::atomic<size_t> nextTask{0};
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (size_t w = 0; w < workerCount; ++w) {
+        workers.emplace_back([this, &bounds, &results, &arenas, &nextTask, tasks, w] {
+            size_t task;
+            while ((task = nextTask.fetch_add(1, std::memory_order_relaxed)) < tasks) {
+                Parser worker(*tokens, arenas[w], bounds[task], bounds[task + 1]);
+                worker.concurrent = true;
+                results[task].program = worker.parseProgram();
+                results[task].errors = std::move(worker.errors);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    for (const ParsedRange& result : results) {
+        if (!result.errors.empty()) return parse();   // The workers' trees go with their arenas
+    }
+
+    for (AstArena& workerArena : arenas) arena.adopt(workerArena);
+    size_t total = 0;
+    for (const ParsedRange& result : results) total += result.program->globals.size();
+    auto program = arena.make<Program>();
+    program->globals.reserve(total);
+    for (ParsedRange& result : results) {
+        for (auto& decl : result.program->globals) program->globals.push_back(std::move(decl));
     }
+
+    nextIndex = endIndex;   // Leave the parser at the end of input, as parse() does
+    advance();
     return program;
 }
 
+std::string formatDiagnostic(const Diagnostic& diag, const Lexer& lexer) {
+    std::string_view file = lexer.fileName(diag.file);
+    const LineIndex& lines = lexer.lineIndexFor(diag.file);
+    std::string text(file.empty() ? std::string_view("<source>") : file);
+    text += ':' + std::to_string(lines.lineOf(diag.offset)) + ':' + std::to_string(lines.columnOf(diag.offset)) + ": ";
+    text += parseDiagMessage(diag.id);
+    text += " (found ";
+    text += tokenTypeName(diag.found);
+    text += ')';
+    return text;
+}
+
 // --- Declarations ---
-std::unique_ptr<ASTNode> Parser::parseDeclaration() {
+ArenaPtr<ASTNode> Parser::parseDeclaration() {
     if (match(TokenType::CLASS)) return parseClassDecl();
-    if (match(TokenType::STRUCT)) return parseStructDecl();
-    if (match(TokenType::ENUM)) return parseEnumDecl();
-    if (match(TokenType::UNION)) return parseUnionDecl();
-    if (match(TokenType::NAMESPACE)) return parseNamespaceDecl();
-    if (match(TokenType::TYPEDEF)) return parseTypedefDecl();
-    if (match(TokenType::USING)) return parseUsingDirective();
-    if (isTypeToken(current.type())) {
-        // Could be variable or function
-        Token lookahead = current;
-        advance();
-        if (current.type() == TokenType::IDENTIFIER) {
-            Token nameToken = current;
-            advance();
-            if (current.type() == TokenType::LEFT_PAREN) {
-                // Function
-                return parseFunctionDecl();
-            } else {
-                // Variable
-                return parseVariableDecl();
-            }
+    // The rules below expect their own keyword
+    if (check(TokenType::STRUCT)) return parseStructDecl();
+    if (check(TokenType::ENUM)) return parseEnumDecl();
+    if (check(TokenType::UNION)) return parseUnionDecl();
+    if (check(TokenType::NAMESPACE)) return parseNamespaceDecl();
+    if (check(TokenType::TYPEDEF)) return parseTypedefDecl();
+    if (check(TokenType::USING)) return parseUsingDirective();
+    if (isTypeToken(current.type()) && peekType(0) == TokenType::IDENTIFIER) {
+        // Could be variable or function: <type> <name> '(' ... is a function
+        if (peekType(1) == TokenType::LEFT_PAREN) {
+            return parseFunctionDecl();
         }
+        return parseVariableDecl();
     }
     return parseStatement();
 }
@@ -104,294 +448,305 @@ bool Parser::isTypeToken(TokenType type) {
 
 // --- Example: Class Declaration ---
 
-std::unique_ptr<ASTNode> Parser::parseClassDecl() {
-    expect(TokenType::IDENTIFIER, "Expected class name");
+ArenaPtr<ASTNode> Parser::parseClassDecl() {
+    expect(TokenType::IDENTIFIER, ParseDiag::ExpectedClassName);
     std::string name = previous().text(); // FIX: use previous().text()
-    expect(TokenType::LEFT_BRACE, "Expected '{' after class name");
-    auto classNode = std::make_unique<ClassDecl>(name);
+    expect(TokenType::LEFT_BRACE, ParseDiag::ExpectedLBraceAfterClassName);
+    auto classNode = arena.make<ClassDecl>(name);
     while (current.type() != TokenType::RIGHT_BRACE && current.type() != TokenType::END_OF_FILE) {
+        size_t start = consumed;
         if (match(TokenType::PUBLIC)) {
-            expect(TokenType::COLON, "Expected ':' after 'public'");
+            expect(TokenType::COLON, ParseDiag::ExpectedColonAfterPublic);
             // Optionally store access specifier in AST
             continue;
         }
         if (match(TokenType::PRIVATE)) {
-            expect(TokenType::COLON, "Expected ':' after 'private'");
+            expect(TokenType::COLON, ParseDiag::ExpectedColonAfterPrivate);
             continue;
         }
         if (match(TokenType::PROTECTED)) {
-            expect(TokenType::COLON, "Expected ':' after 'protected'");
+            expect(TokenType::COLON, ParseDiag::ExpectedColonAfterProtected);
             continue;
         }
         classNode->members.push_back(parseDeclaration());
+        recover(start);
     }
-    expect(TokenType::RIGHT_BRACE, "Expected '}' after class body");
+    expect(TokenType::RIGHT_BRACE, ParseDiag::ExpectedRBraceAfterClassBody);
     return classNode;
 }
-std::unique_ptr<ASTNode> Parser::parseStructDecl() {
-    expect(TokenType::STRUCT, "Expected 'struct'");
-    expect(TokenType::IDENTIFIER, "Expected struct name");
+ArenaPtr<ASTNode> Parser::parseStructDecl() {
+    expect(TokenType::STRUCT, ParseDiag::ExpectedStruct);
+    expect(TokenType::IDENTIFIER, ParseDiag::ExpectedStructName);
     std::string name = previous().text(); // FIX: use previous().text()
-    expect(TokenType::LEFT_BRACE, "Expected '{' after struct name");
-    auto structNode = std::make_unique<StructDecl>(name);
+    expect(TokenType::LEFT_BRACE, ParseDiag::ExpectedLBraceAfterStructName);
+    auto structNode = arena.make<StructDecl>(name);
 
     while (current.type() != TokenType::RIGHT_BRACE && current.type() != TokenType::END_OF_FILE) {
+        size_t start = consumed;
         // Handle access specifiers if needed
         if (match(TokenType::PUBLIC)) {
-            expect(TokenType::COLON, "Expected ':' after 'public'");
+            expect(TokenType::COLON, ParseDiag::ExpectedColonAfterPublic);
             continue;
         }
         if (match(TokenType::PRIVATE)) {
-            expect(TokenType::COLON, "Expected ':' after 'private'");
+            expect(TokenType::COLON, ParseDiag::ExpectedColonAfterPrivate);
             continue;
         }
         if (match(TokenType::PROTECTED)) {
-            expect(TokenType::COLON, "Expected ':' after 'protected'");
+            expect(TokenType::COLON, ParseDiag::ExpectedColonAfterProtected);
             continue;
         }
         structNode->members.push_back(parseDeclaration());
+        recover(start);
     }
-    expect(TokenType::RIGHT_BRACE, "Expected '}' after struct body");
-    // Optionally expect(TokenType::SEMICOLON, "Expected ';' after struct declaration");
+    expect(TokenType::RIGHT_BRACE, ParseDiag::ExpectedRBraceAfterStructBody);
+    // Optionally expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterStructDeclaration);
     return structNode;
 }
 
 // --- Example: Variable Declaration ---
-std::unique_ptr<ASTNode> Parser::parseVariableDecl() {
-    std::string typeName = current.text();
+ArenaPtr<ASTNode> Parser::parseVariableDecl() {
+    Symbol typeName = symbolOf(current);
     advance();
-    expect(TokenType::IDENTIFIER, "Expected variable name");
-    std::string varName = previous().text(); // FIX: use previous().text()
-    auto varNode = std::make_unique<VarDecl>(varName);
-    varNode->type = std::make_unique<Identifier>(typeName);
+    expect(TokenType::IDENTIFIER, ParseDiag::ExpectedVariableName);
+    Symbol varName = symbolOf(previous());
+    auto varNode = arena.make<VarDecl>(varName);
+    varNode->type = arena.make<Identifier>(typeName);
     if (match(TokenType::EQUAL)) {
         varNode->initializer = parseExpression();
     }
-    expect(TokenType::SEMICOLON, "Expected ';' after variable declaration");
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterVariableDeclaration);
     return varNode;
 }
 
 // --- Example: Function Declaration ---
-std::unique_ptr<ASTNode> Parser::parseFunctionDecl() {
-    std::string returnType = current.text();
+ArenaPtr<ASTNode> Parser::parseFunctionDecl() {
+    Symbol returnType = symbolOf(current);
     advance();
-    expect(TokenType::IDENTIFIER, "Expected function name");
-    std::string funcName = previous().text();
-    expect(TokenType::LEFT_PAREN, "Expected '(' after function name");
-    auto funcNode = std::make_unique<FunctionDecl>(funcName);
-    funcNode->returnType = std::make_unique<Identifier>(returnType);
+    expect(TokenType::IDENTIFIER, ParseDiag::ExpectedFunctionName);
+    Symbol funcName = symbolOf(previous());
+    expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterFunctionName);
+    auto funcNode = arena.make<FunctionDecl>(funcName);
+    funcNode->returnType = arena.make<Identifier>(returnType);
     // Parse parameters (not shown here)
-    expect(TokenType::RIGHT_PAREN, "Expected ')' after parameters");
+    expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParenAfterParameters);
     funcNode->body = parseBlock();
     return funcNode;
 }
 
 // --- Example: Block ---
-std::unique_ptr<ASTNode> Parser::parseBlock() {
-    expect(TokenType::LEFT_BRACE, "Expected '{' to start block");
-    auto block = std::make_unique<BlockStmt>();
+ArenaPtr<ASTNode> Parser::parseBlock() {
+    expect(TokenType::LEFT_BRACE, ParseDiag::ExpectedLBraceToStartBlock);
+    auto block = arena.make<BlockStmt>();
     while (current.type() != TokenType::RIGHT_BRACE && current.type() != TokenType::END_OF_FILE) {
+        size_t start = consumed;
         block->statements.push_back(parseStatement());
+        recover(start);
     }
-    expect(TokenType::RIGHT_BRACE, "Expected '}' to end block");
+    expect(TokenType::RIGHT_BRACE, ParseDiag::ExpectedRBraceToEndBlock);
     return block;
 }
 
 // --- Example: Statement ---
-std::unique_ptr<ASTNode> Parser::parseStatement() {
-    if (match(TokenType::IF)) return parseIfStmt();
-    if (match(TokenType::WHILE)) return parseWhileStmt();
-    if (match(TokenType::FOR)) return parseForStmt();
-    if (match(TokenType::RETURN)) return parseReturnStmt();
+ArenaPtr<ASTNode> Parser::parseStatement() {
+    if (check(TokenType::IF)) return parseIfStmt();
+    if (check(TokenType::WHILE)) return parseWhileStmt();
+    if (check(TokenType::FOR)) return parseForStmt();
+    if (check(TokenType::RETURN)) return parseReturnStmt();
     if (current.type() == TokenType::LEFT_BRACE) return parseBlock();
+    if (isTypeToken(current.type()) && peekType(0) == TokenType::IDENTIFIER) return parseVariableDecl();
     // Fallback: expression statement
-    auto expr = parseExpression();
-    expect(TokenType::SEMICOLON, "Expected ';' after expression");
-    return std::make_unique<ExpressionStmt>(std::move(expr));
+    auto expr = parseExpression(kCommaPower);
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterExpression);
+    return arena.make<ExpressionStmt>(std::move(expr));
 }
 
 // --- Example: Expression (expand as needed) ---
-// std::unique_ptr<ASTNode> Parser::parseExpression() {
+// ArenaPtr<ASTNode> Parser::parseExpression() {
 //     // For now, just parse a primary (expand with precedence climbing)
 //     return parsePrimary();
 // }
 
-std::unique_ptr<ASTNode> Parser::parsePrimary() {
+ArenaPtr<ASTNode> Parser::parsePrimary() {
     // C++ casts
     if (match(TokenType::STATIC_CAST)) {
-        expect(TokenType::LESS, "Expected '<' after static_cast");
+        expect(TokenType::LESS, ParseDiag::ExpectedLessAfterStaticCast);
         auto type = parseType();
-        expect(TokenType::GREATER, "Expected '>' after type");
-        expect(TokenType::LEFT_PAREN, "Expected '(' after '>'");
+        expect(TokenType::GREATER, ParseDiag::ExpectedGreaterAfterType);
+        expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterGreater);
         auto expr = parseExpression();
-        expect(TokenType::RIGHT_PAREN, "Expected ')'");
-        return std::make_unique<StaticCastExpr>(std::move(type), std::move(expr));
+        expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParen);
+        return arena.make<StaticCastExpr>(std::move(type), std::move(expr));
     }
     if (match(TokenType::DYNAMIC_CAST)) {
-        expect(TokenType::LESS, "Expected '<' after dynamic_cast");
+        expect(TokenType::LESS, ParseDiag::ExpectedLessAfterDynamicCast);
         auto type = parseType();
-        expect(TokenType::GREATER, "Expected '>' after type");
-        expect(TokenType::LEFT_PAREN, "Expected '(' after '>'");
+        expect(TokenType::GREATER, ParseDiag::ExpectedGreaterAfterType);
+        expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterGreater);
         auto expr = parseExpression();
-        expect(TokenType::RIGHT_PAREN, "Expected ')'");
-        return std::make_unique<DynamicCastExpr>(std::move(type), std::move(expr));
+        expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParen);
+        return arena.make<DynamicCastExpr>(std::move(type), std::move(expr));
     }
     if (match(TokenType::CONST_CAST)) {
-        expect(TokenType::LESS, "Expected '<' after const_cast");
+        expect(TokenType::LESS, ParseDiag::ExpectedLessAfterConstCast);
         auto type = parseType();
-        expect(TokenType::GREATER, "Expected '>' after type");
-        expect(TokenType::LEFT_PAREN, "Expected '(' after '>'");
+        expect(TokenType::GREATER, ParseDiag::ExpectedGreaterAfterType);
+        expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterGreater);
         auto expr = parseExpression();
-        expect(TokenType::RIGHT_PAREN, "Expected ')'");
-        return std::make_unique<ConstCastExpr>(std::move(type), std::move(expr));
+        expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParen);
+        return arena.make<ConstCastExpr>(std::move(type), std::move(expr));
     }
     if (match(TokenType::REINTERPRET_CAST)) {
-        expect(TokenType::LESS, "Expected '<' after reinterpret_cast");
+        expect(TokenType::LESS, ParseDiag::ExpectedLessAfterReinterpretCast);
         auto type = parseType();
-        expect(TokenType::GREATER, "Expected '>' after type");
-        expect(TokenType::LEFT_PAREN, "Expected '(' after '>'");
+        expect(TokenType::GREATER, ParseDiag::ExpectedGreaterAfterType);
+        expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterGreater);
         auto expr = parseExpression();
-        expect(TokenType::RIGHT_PAREN, "Expected ')'");
-        return std::make_unique<ReinterpretCastExpr>(std::move(type), std::move(expr));
+        expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParen);
+        return arena.make<ReinterpretCastExpr>(std::move(type), std::move(expr));
     }
 
     // new/delete
     if (match(TokenType::NEW)) {
         auto type = parseType();
-        std::vector<std::unique_ptr<ASTNode>> args;
+        std::vector<ArenaPtr<ASTNode>> args;
         if (match(TokenType::LEFT_PAREN)) {
             if (!check(TokenType::RIGHT_PAREN)) {
                 do {
                     args.push_back(parseExpression());
                 } while (match(TokenType::COMMA));
             }
-            expect(TokenType::RIGHT_PAREN, "Expected ')' after new arguments");
+            expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParenAfterNewArguments);
         }
-        return std::make_unique<NewExpr>(std::move(type), std::move(args));
+        return arena.make<NewExpr>(std::move(type), std::move(args));
     }
     if (match(TokenType::DELETE)) {
         auto expr = parseExpression();
-        return std::make_unique<DeleteExpr>(std::move(expr));
+        return arena.make<DeleteExpr>(std::move(expr));
     }
 
     // Lambda
     if (match(TokenType::LEFT_BRACKET)) {
         // Parse capture list (skip for now)
-        while (!match(TokenType::RIGHT_BRACKET)) advance();
-        expect(TokenType::LEFT_PAREN, "Expected '(' after lambda capture");
-        std::vector<std::unique_ptr<ASTNode>> params;
+        while (!isAtEnd() && !match(TokenType::RIGHT_BRACKET)) advance();
+        expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterLambdaCapture);
+        std::vector<ArenaPtr<ASTNode>> params;
         if (!check(TokenType::RIGHT_PAREN)) {
             do {
                 auto type = parseType();
-                expect(TokenType::IDENTIFIER, "Expected parameter name");
-                std::string name = previous().text();
-                params.push_back(std::make_unique<VarDecl>(name, std::move(type)));
+                expect(TokenType::IDENTIFIER, ParseDiag::ExpectedParameterName);
+                Symbol name = symbolOf(previous());
+                params.push_back(arena.make<VarDecl>(name, std::move(type)));
             } while (match(TokenType::COMMA));
         }
-        expect(TokenType::RIGHT_PAREN, "Expected ')' after lambda params");
+        expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParenAfterLambdaParams);
         auto body = parseBlock();
-        return std::make_unique<LambdaExpr>(std::move(params), std::move(body));
+        return arena.make<LambdaExpr>(std::move(params), std::move(body));
     }
 
-    // Literals
+    // Literals (match() has moved past the token: read it from previous())
     if (match(TokenType::INTEGER)) {
-        return std::make_unique<Literal>(current.text(), "int");
+        return arena.make<Literal>(previous().text(), "int");
     }
     if (match(TokenType::FLOAT)) {
-        return std::make_unique<Literal>(current.text(), "float");
+        return arena.make<Literal>(previous().text(), "float");
     }
-    if (match(TokenType::STRING)) {
-        return std::make_unique<Literal>(current.text(), "string");
+    if (match(TokenType::STRING) || match(TokenType::STRING_LITERAL)) {
+        Token literal = previous();
+        return arena.make<Literal>(literal.text(), "string", literal.has_escape());
     }
-    if (match(TokenType::CHARACTER)) {
-        return std::make_unique<Literal>(current.text(), "char");
+    if (match(TokenType::CHARACTER) || match(TokenType::CHAR_LITERAL)) {
+        Token literal = previous();
+        return arena.make<Literal>(literal.text(), "char", literal.has_escape());
     }
 
     // Identifier
-    if (match(TokenType::IDENTIFIER)) {
-        return std::make_unique<Identifier>(current.text());
+    if (match(TokenType::IDENTIFIER) || (isStreamToken(current.type()) && match(current.type()))) {
+        return arena.make<Identifier>(symbolOf(previous()));
     }
 
     // Parenthesized expression
     if (match(TokenType::LEFT_PAREN)) {
-        auto expr = parseExpression();
-        expect(TokenType::RIGHT_PAREN, "Expected ')'");
+        auto expr = parseExpression(kCommaPower);
+        expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParen);
         return expr;
     }
 
-    throw std::runtime_error("Unexpected token in expression");
+    report(ParseDiag::UnexpectedTokenInExpression);
+    return nullptr;
 }
 
 // --- parseCatchStmt ---
-std::unique_ptr<ASTNode> Parser::parseCatchStmt() {
-    expect(TokenType::CATCH, "Expected 'catch'");
-    expect(TokenType::LEFT_PAREN, "Expected '(' after 'catch'");
+ArenaPtr<ASTNode> Parser::parseCatchStmt() {
+    expect(TokenType::CATCH, ParseDiag::ExpectedCatch);
+    expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterCatch);
     auto exceptionType = parseType(); // FIXED: use auto, not std::string
-    expect(TokenType::IDENTIFIER, "Expected exception variable name");
+    expect(TokenType::IDENTIFIER, ParseDiag::ExpectedExceptionVariableName);
     std::string name = previous().text();
-    expect(TokenType::RIGHT_PAREN, "Expected ')' after catch parameter");
+    expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParenAfterCatchParameter);
     auto body = parseBlock();
-    return std::make_unique<CatchStmt>(std::move(exceptionType), name, std::move(body));
+    return arena.make<CatchStmt>(std::move(exceptionType), name, std::move(body));
 }
 
 // --- parseTryStmt ---
-std::unique_ptr<ASTNode> Parser::parseTryStmt() {
-    expect(TokenType::TRY, "Expected 'try'");
+ArenaPtr<ASTNode> Parser::parseTryStmt() {
+    expect(TokenType::TRY, ParseDiag::ExpectedTry);
     auto tryBlock = parseBlock();
-    std::vector<std::unique_ptr<ASTNode>> catches;
+    std::vector<ArenaPtr<ASTNode>> catches;
     while (check(TokenType::CATCH)) {
         catches.push_back(parseCatchStmt());
     }
-    return std::make_unique<TryStmt>(std::move(tryBlock), std::move(catches));
+    return arena.make<TryStmt>(std::move(tryBlock), std::move(catches));
 }
 
 // --- parseThrowStmt ---
-std::unique_ptr<ASTNode> Parser::parseThrowStmt() {
-    expect(TokenType::THROW, "Expected 'throw'");
+ArenaPtr<ASTNode> Parser::parseThrowStmt() {
+    expect(TokenType::THROW, ParseDiag::ExpectedThrow);
     auto expr = parseExpression();
-    expect(TokenType::SEMICOLON, "Expected ';' after throw statement");
-    return std::make_unique<ThrowStmt>(std::move(expr));
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterThrowStatement);
+    return arena.make<ThrowStmt>(std::move(expr));
 }
 
 // --- parseBreakStmt ---
-std::unique_ptr<ASTNode> Parser::parseBreakStmt() {
-    expect(TokenType::BREAK, "Expected 'break'");
-    expect(TokenType::SEMICOLON, "Expected ';' after break");
-    return std::make_unique<BreakStmt>();
+ArenaPtr<ASTNode> Parser::parseBreakStmt() {
+    expect(TokenType::BREAK, ParseDiag::ExpectedBreak);
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterBreak);
+    return arena.make<BreakStmt>();
 }
 
 // --- parseContinueStmt ---
-std::unique_ptr<ASTNode> Parser::parseContinueStmt() {
-    expect(TokenType::CONTINUE, "Expected 'continue'");
-    expect(TokenType::SEMICOLON, "Expected ';' after continue");
-    return std::make_unique<ContinueStmt>();
+ArenaPtr<ASTNode> Parser::parseContinueStmt() {
+    expect(TokenType::CONTINUE, ParseDiag::ExpectedContinue);
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterContinue);
+    return arena.make<ContinueStmt>();
 }
 
 // --- parseGotoStmt ---
-std::unique_ptr<ASTNode> Parser::parseGotoStmt() {
-    expect(TokenType::GOTO, "Expected 'goto'");
-    expect(TokenType::IDENTIFIER, "Expected label after 'goto'");
+ArenaPtr<ASTNode> Parser::parseGotoStmt() {
+    expect(TokenType::GOTO, ParseDiag::ExpectedGoto);
+    expect(TokenType::IDENTIFIER, ParseDiag::ExpectedLabelAfterGoto);
     std::string name = previous().text();
-    expect(TokenType::SEMICOLON, "Expected ';' after goto statement");
-    return std::make_unique<GotoStmt>(name); 
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterGotoStatement);
+    return arena.make<GotoStmt>(name); 
 }
 
 // --- parseElseStmt ---
-std::unique_ptr<ASTNode> Parser::parseElseStmt() {
-    expect(TokenType::ELSE, "Expected 'else'");
+ArenaPtr<ASTNode> Parser::parseElseStmt() {
+    expect(TokenType::ELSE, ParseDiag::ExpectedElse);
     auto elseBranch = parseStatement();
-    return std::make_unique<ElseStmt>(std::move(elseBranch));
+    return arena.make<ElseStmt>(std::move(elseBranch));
 }
 
 // --- parseSwitchStmt ---
-std::unique_ptr<ASTNode> Parser::parseSwitchStmt() {
-    expect(TokenType::SWITCH, "Expected 'switch'");
-    expect(TokenType::LEFT_PAREN, "Expected '(' after 'switch'");
+ArenaPtr<ASTNode> Parser::parseSwitchStmt() {
+    expect(TokenType::SWITCH, ParseDiag::ExpectedSwitch);
+    expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterSwitch);
     auto condition = parseExpression();
-    expect(TokenType::RIGHT_PAREN, "Expected ')' after switch condition");
-    expect(TokenType::LEFT_BRACE, "Expected '{' after switch");
-    std::vector<std::unique_ptr<ASTNode>> cases;
+    expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParenAfterSwitchCondition);
+    expect(TokenType::LEFT_BRACE, ParseDiag::ExpectedLBraceAfterSwitch);
+    std::vector<ArenaPtr<ASTNode>> cases;
     while (!check(TokenType::RIGHT_BRACE) && !isAtEnd()) {
+        size_t start = consumed;
         if (check(TokenType::CASE)) {
             cases.push_back(parseCaseStmt());
         } else if (check(TokenType::DEFAULT)) {
@@ -399,285 +754,283 @@ std::unique_ptr<ASTNode> Parser::parseSwitchStmt() {
         } else {
             cases.push_back(parseStatement());
         }
+        recover(start);
     }
-    expect(TokenType::RIGHT_BRACE, "Expected '}' after switch body");
-    return std::make_unique<SwitchStmt>(std::move(condition), std::move(cases));
+    expect(TokenType::RIGHT_BRACE, ParseDiag::ExpectedRBraceAfterSwitchBody);
+    return arena.make<SwitchStmt>(std::move(condition), std::move(cases));
 }
 
 // --- parseCaseStmt ---
-std::unique_ptr<ASTNode> Parser::parseCaseStmt() {
-    expect(TokenType::CASE, "Expected 'case'");
+ArenaPtr<ASTNode> Parser::parseCaseStmt() {
+    expect(TokenType::CASE, ParseDiag::ExpectedCase);
     auto value = parseExpression();
-    expect(TokenType::COLON, "Expected ':' after case value");
-    std::vector<std::unique_ptr<ASTNode>> statements;
+    expect(TokenType::COLON, ParseDiag::ExpectedColonAfterCaseValue);
+    std::vector<ArenaPtr<ASTNode>> statements;
     while (!check(TokenType::CASE) && !check(TokenType::DEFAULT) && !check(TokenType::RIGHT_BRACE) && !isAtEnd()) {
+        size_t start = consumed;
         statements.push_back(parseStatement());
+        recover(start);
     }
-    return std::make_unique<CaseStmt>(std::move(value), std::move(statements));
+    return arena.make<CaseStmt>(std::move(value), std::move(statements));
 }
 
 // --- parseDefaultStmt ---
-std::unique_ptr<ASTNode> Parser::parseDefaultStmt() {
-    expect(TokenType::DEFAULT, "Expected 'default'");
-    expect(TokenType::COLON, "Expected ':' after default");
-    std::vector<std::unique_ptr<ASTNode>> statements;
+ArenaPtr<ASTNode> Parser::parseDefaultStmt() {
+    expect(TokenType::DEFAULT, ParseDiag::ExpectedDefault);
+    expect(TokenType::COLON, ParseDiag::ExpectedColonAfterDefault);
+    std::vector<ArenaPtr<ASTNode>> statements;
     while (!check(TokenType::CASE) && !check(TokenType::DEFAULT) && !check(TokenType::RIGHT_BRACE) && !isAtEnd()) {
+        size_t start = consumed;
         statements.push_back(parseStatement());
+        recover(start);
     }
-    return std::make_unique<DefaultStmt>(std::move(statements));
+    return arena.make<DefaultStmt>(std::move(statements));
 }
 
 // --- parseDoWhileStmt ---
-std::unique_ptr<ASTNode> Parser::parseDoWhileStmt() {
-    expect(TokenType::DO, "Expected 'do'");
+ArenaPtr<ASTNode> Parser::parseDoWhileStmt() {
+    expect(TokenType::DO, ParseDiag::ExpectedDo);
     auto body = parseStatement();
-    expect(TokenType::WHILE, "Expected 'while' after do body");
-    expect(TokenType::LEFT_PAREN, "Expected '(' after 'while'");
+    expect(TokenType::WHILE, ParseDiag::ExpectedWhileAfterDoBody);
+    expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterWhile);
     auto condition = parseExpression();
-    expect(TokenType::RIGHT_PAREN, "Expected ')' after do-while condition");
-    expect(TokenType::SEMICOLON, "Expected ';' after do-while");
-    return std::make_unique<DoWhileStmt>(std::move(condition), std::move(body));
+    expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParenAfterDoWhileCondition);
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterDoWhile);
+    return arena.make<DoWhileStmt>(std::move(condition), std::move(body));
 }
 
 // --- parseUnionDecl ---
-std::unique_ptr<ASTNode> Parser::parseUnionDecl() {
-    expect(TokenType::UNION, "Expected 'union'");
+ArenaPtr<ASTNode> Parser::parseUnionDecl() {
+    expect(TokenType::UNION, ParseDiag::ExpectedUnion);
     // if (!check(TokenType::IDENTIFIER)) error("Expected union name");
     // std::string unionName = advance()->lexeme;
-    expect(TokenType::IDENTIFIER, "Expected union name");
+    expect(TokenType::IDENTIFIER, ParseDiag::ExpectedUnionName);
     std::string name = previous().text();
 
-    expect(TokenType::LEFT_BRACE, "Expected '{' after union name");
-    std::vector<std::unique_ptr<ASTNode>> members;
+    expect(TokenType::LEFT_BRACE, ParseDiag::ExpectedLBraceAfterUnionName);
+    std::vector<ArenaPtr<ASTNode>> members;
     while (!check(TokenType::RIGHT_BRACE) && !isAtEnd()) {
+        size_t start = consumed;
         members.push_back(parseVariableDecl());
-        expect(TokenType::SEMICOLON, "Expected ';' after union member");
+        expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterUnionMember);
+        recover(start);
     }
-    expect(TokenType::RIGHT_BRACE, "Expected '}' after union body");
-    expect(TokenType::SEMICOLON, "Expected ';' after union declaration");
-   return std::make_unique<UnionDecl>(name, std::move(members));
+    expect(TokenType::RIGHT_BRACE, ParseDiag::ExpectedRBraceAfterUnionBody);
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterUnionDeclaration);
+   return arena.make<UnionDecl>(name, std::move(members));
+}
+
+// --- parseEnumDecl ---
+ArenaPtr<ASTNode> Parser::parseEnumDecl() {
+    expect(TokenType::ENUM, ParseDiag::ExpectedEnum);
+    if (!match(TokenType::CLASS)) match(TokenType::STRUCT);   // Scoped enum
+    expect(TokenType::IDENTIFIER, ParseDiag::ExpectedEnumName);
+    auto enumNode = arena.make<EnumDecl>(previous().text());
+
+    expect(TokenType::LEFT_BRACE, ParseDiag::ExpectedLBraceAfterEnumName);
+    while (!check(TokenType::RIGHT_BRACE) && !isAtEnd()) {
+        size_t start = consumed;
+        if (expect(TokenType::IDENTIFIER, ParseDiag::ExpectedEnumeratorName)) {
+            std::string name = previous().text();
+            int value = -1;
+            if (match(TokenType::EQUAL) &&
+                expect(TokenType::INTEGER, ParseDiag::ExpectedEnumeratorValue)) {
+                value = static_cast<int>(previous().int_value());
+            }
+            enumNode->enumerators.emplace_back(std::move(name), value);
+        }
+        recover(start);
+        if (!match(TokenType::COMMA)) break;   // A trailing comma is allowed
+    }
+    expect(TokenType::RIGHT_BRACE, ParseDiag::ExpectedRBraceAfterEnumBody);
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterEnumDeclaration);
+    return enumNode;
 }
 
 // --- parseTypedefDecl ---
-std::unique_ptr<ASTNode> Parser::parseTypedefDecl() {
-    expect(TokenType::TYPEDEF, "Expected 'typedef'");
+ArenaPtr<ASTNode> Parser::parseTypedefDecl() {
+    expect(TokenType::TYPEDEF, ParseDiag::ExpectedTypedef);
     auto aliasedType = parseType(); 
-    expect(TokenType::IDENTIFIER, "Expected typedef alias name");
+    expect(TokenType::IDENTIFIER, ParseDiag::ExpectedTypedefAliasName);
     std::string name = previous().text();
-    expect(TokenType::SEMICOLON, "Expected ';' after typedef");
-    return std::make_unique<TypedefDecl>(name, std::move(aliasedType));
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterTypedef);
+    return arena.make<TypedefDecl>(name, std::move(aliasedType));
 }
 
 // --- parseTemplateTypeSuffix ---
-std::unique_ptr<ASTNode> Parser::parseTemplateTypeSuffix(std::string baseName) {
-    expect(TokenType::LESS, "Expected '<' for template type");
-    std::vector<std::unique_ptr<ASTNode>> typeArgs;
+ArenaPtr<ASTNode> Parser::parseTemplateTypeSuffix(std::string baseName) {
+    expect(TokenType::LESS, ParseDiag::ExpectedLessForTemplateType);
+    std::vector<ArenaPtr<ASTNode>> typeArgs;
     do {
         typeArgs.push_back(parseType());
     } while (match(TokenType::COMMA));
-    expect(TokenType::GREATER, "Expected '>' after template arguments");
-    return std::make_unique<TemplateType>(baseName, std::move(typeArgs));
+    expect(TokenType::GREATER, ParseDiag::ExpectedGreaterAfterTemplateArguments);
+    return arena.make<TemplateType>(baseName, std::move(typeArgs));
 }
 
 // --- parseFunctionCallSuffix ---
-std::unique_ptr<ASTNode> Parser::parseFunctionCallSuffix(std::unique_ptr<ASTNode> callee) {
-    expect(TokenType::LEFT_PAREN, "Expected '(' after function name");
-    std::vector<std::unique_ptr<ASTNode>> args;
+ArenaPtr<ASTNode> Parser::parseFunctionCallSuffix(ArenaPtr<ASTNode> callee) {
+    expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterFunctionName);
+    std::vector<ArenaPtr<ASTNode>> args;
     if (!check(TokenType::RIGHT_PAREN)) {
         do {
             args.push_back(parseExpression());
         } while (match(TokenType::COMMA));
     }
-    expect(TokenType::RIGHT_PAREN, "Expected ')' after arguments");
-    return std::make_unique<FunctionCall>(std::move(callee), std::move(args));
+    expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParenAfterArguments);
+    return arena.make<FunctionCall>(std::move(callee), std::move(args));
 }
 
 // --- parseStreamExpr ---
-std::unique_ptr<ASTNode> Parser::parseStreamExpr() {
-    // Example: cout << x << y;
-    auto stream = parsePrimary();
-    while (match(TokenType::LESS_LESS) || match(TokenType::GREATER_GREATER)) {
-        Token op = previous();
-        auto right = parseExpression();
-        stream = std::make_unique<StreamExpr>(std::move(stream), op.text(), std::move(right));
-    }
-    return stream;
-}
-std::unique_ptr<ASTNode> Parser::parseWhileStmt() {
-    expect(TokenType::WHILE, "Expected 'while'");
-    expect(TokenType::LEFT_PAREN, "Expected '(' after 'while'");
+// Called by parseExpression at the first "<<" or ">>" after a stream object.
+// Example: cout << x << y; one StreamExpr holding [cout, x, y]. A change of
+// operator ends the chain.
+ArenaPtr<ASTNode> Parser::parseStreamExpr(ArenaPtr<ASTNode> stream) {
+    std::vector<ArenaPtr<ASTNode>> chain;
+    chain.push_back(std::move(stream));
+    TokenType op = current.type();
+    while (match(op)) {
+        chain.push_back(parseExpression(kShiftPower + 1));   // Stops at the next << or >>
+    }
+    return arena.make<StreamExpr>(op == TokenType::LESS_LESS ? "<<" : ">>", std::move(chain));
+}
+ArenaPtr<ASTNode> Parser::parseWhileStmt() {
+    expect(TokenType::WHILE, ParseDiag::ExpectedWhile);
+    expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterWhile);
     auto condition = parseExpression();
-    expect(TokenType::RIGHT_PAREN, "Expected ')' after condition");
+    expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParenAfterCondition);
     auto body = parseStatement();
     // Assuming WhileStmt(condition, body)
-    return std::make_unique<WhileStmt>(std::move(condition), std::move(body));
+    return arena.make<WhileStmt>(std::move(condition), std::move(body));
 }
 
-std::unique_ptr<ASTNode> Parser::parseForStmt() {
-    expect(TokenType::FOR, "Expected 'for'");
-    expect(TokenType::LEFT_PAREN, "Expected '(' after 'for'");
-    std::unique_ptr<ASTNode> init = nullptr;
+ArenaPtr<ASTNode> Parser::parseForStmt() {
+    expect(TokenType::FOR, ParseDiag::ExpectedFor);
+    expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterFor);
+    ArenaPtr<ASTNode> init = nullptr;
     if (!match(TokenType::SEMICOLON))
         init = parseExpression();
-    expect(TokenType::SEMICOLON, "Expected ';' after for-init");
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterForInit);
     auto condition = parseExpression();
-    expect(TokenType::SEMICOLON, "Expected ';' after for-condition");
-    auto increment = parseExpression();
-    expect(TokenType::RIGHT_PAREN, "Expected ')' after for-increment");
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterForCondition);
+    auto increment = parseExpression(kCommaPower);
+    expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParenAfterForIncrement);
     auto body = parseStatement();
     // Assuming ForStmt(init, condition, increment, body)
-    return std::make_unique<ForStmt>(std::move(init), std::move(condition), std::move(increment), std::move(body));
+    return arena.make<ForStmt>(std::move(init), std::move(condition), std::move(increment), std::move(body));
 }
-std::unique_ptr<ASTNode> Parser::parseIfStmt() {
-    expect(TokenType::IF, "Expected 'if'");
-    expect(TokenType::LEFT_PAREN, "Expected '(' after 'if'");
+ArenaPtr<ASTNode> Parser::parseIfStmt() {
+    expect(TokenType::IF, ParseDiag::ExpectedIf);
+    expect(TokenType::LEFT_PAREN, ParseDiag::ExpectedLParenAfterIf);
     auto condition = parseExpression();
-    expect(TokenType::RIGHT_PAREN, "Expected ')' after condition");
+    expect(TokenType::RIGHT_PAREN, ParseDiag::ExpectedRParenAfterCondition);
     auto thenBranch = parseStatement();
-    std::unique_ptr<ASTNode> elseBranch = nullptr;
+    ArenaPtr<ASTNode> elseBranch = nullptr;
     if (match(TokenType::ELSE)) {
         elseBranch = parseStatement();
     }
     // Assuming IfStmt(condition, thenBranch, elseBranch)
-    return std::make_unique<IfStmt>(std::move(condition), std::move(thenBranch), std::move(elseBranch));
+    return arena.make<IfStmt>(std::move(condition), std::move(thenBranch), std::move(elseBranch));
 }
 
-std::unique_ptr<ASTNode> Parser::parseReturnStmt() {
-    expect(TokenType::RETURN, "Expected 'return'");
-    std::unique_ptr<ASTNode> expr = nullptr;
+ArenaPtr<ASTNode> Parser::parseReturnStmt() {
+    expect(TokenType::RETURN, ParseDiag::ExpectedReturn);
+    ArenaPtr<ASTNode> expr = nullptr;
     if (!check(TokenType::SEMICOLON)) {
         expr = parseExpression();
     }
-    expect(TokenType::SEMICOLON, "Expected ';' after return");
-    return std::make_unique<ReturnStmt>(std::move(expr));
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterReturn);
+    return arena.make<ReturnStmt>(std::move(expr));
 }
 
 
 
-std::unique_ptr<ASTNode> Parser::parseNamespaceDecl() {
-    expect(TokenType::NAMESPACE, "Expected 'namespace'");
-    expect(TokenType::IDENTIFIER, "Expected namespace name");
+ArenaPtr<ASTNode> Parser::parseNamespaceDecl() {
+    expect(TokenType::NAMESPACE, ParseDiag::ExpectedNamespace);
+    expect(TokenType::IDENTIFIER, ParseDiag::ExpectedNamespaceName);
     std::string name = previous().text(); // FIX: use previous().text()
-    expect(TokenType::LEFT_BRACE, "Expected '{' after namespace name");
-    auto nsNode = std::make_unique<NamespaceDecl>(name);
+    expect(TokenType::LEFT_BRACE, ParseDiag::ExpectedLBraceAfterNamespaceName);
+    auto nsNode = arena.make<NamespaceDecl>(name);
     while (current.type() != TokenType::RIGHT_BRACE && current.type() != TokenType::END_OF_FILE) {
+        size_t start = consumed;
         nsNode->declarations.push_back(parseDeclaration());
+        recover(start);
     }
-    expect(TokenType::RIGHT_BRACE, "Expected '}' after namespace body");
+    expect(TokenType::RIGHT_BRACE, ParseDiag::ExpectedRBraceAfterNamespaceBody);
     return nsNode;
 }
 
-std::unique_ptr<ASTNode> Parser::parseUsingDirective() {
-    expect(TokenType::USING, "Expected 'using'");
-    expect(TokenType::IDENTIFIER, "Expected identifier after 'using'");
+ArenaPtr<ASTNode> Parser::parseUsingDirective() {
+    expect(TokenType::USING, ParseDiag::ExpectedUsing);
+    expect(TokenType::IDENTIFIER, ParseDiag::ExpectedIdentifierAfterUsing);
     std::string name = previous().text(); // FIX: use previous().text()
-    expect(TokenType::SEMICOLON, "Expected ';' after using directive");
-    return std::make_unique<UsingDirective>(name);
+    expect(TokenType::SEMICOLON, ParseDiag::ExpectedSemicolonAfterUsingDirective);
+    return arena.make<UsingDirective>(name);
 }
 
 // --- Expression Parsing with Precedence ---
-std::unique_ptr<ASTNode> Parser::parseExpression() {
-    return parseTernary();
-}
-
-std::unique_ptr<ASTNode> Parser::parseTernary() {
-    auto cond = parseLogicalOr();
-    if (match(TokenType::QUESTION)) {
-        auto thenExpr = parseExpression();
-        expect(TokenType::COLON, "Expected ':' in ternary expression");
-        auto elseExpr = parseExpression();
-        return std::make_unique<TernaryExpr>(std::move(cond), std::move(thenExpr), std::move(elseExpr));
-    }
-    return cond;
-}
-
-std::unique_ptr<ASTNode> Parser::parseLogicalOr() {
-    auto left = parseLogicalAnd();
-    while (match(TokenType::OR_OR)) {
-        auto right = parseLogicalAnd();
-        left = std::make_unique<BinaryExpr>("||", std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseLogicalAnd() {
-    auto left = parseEquality();
-    while (match(TokenType::AND_AND)) {
-        auto right = parseEquality();
-        left = std::make_unique<BinaryExpr>("&&", std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseEquality() {
-    auto left = parseRelational();
-    while (match(TokenType::EQUAL_EQUAL) || match(TokenType::NOT_EQUAL)) {
-        std::string op = previous().text();
-        auto right = parseRelational();
-        left = std::make_unique<BinaryExpr>(op, std::move(left), std::move(right));
-    }
-    return left;
-}
 
-std::unique_ptr<ASTNode> Parser::parseRelational() {
-    auto left = parseAdditive();
-    while (match(TokenType::LESS) || match(TokenType::LESS_EQUAL) ||
-           match(TokenType::GREATER) || match(TokenType::GREATER_EQUAL)) {
-        std::string op = previous().text();
-        auto right = parseAdditive();
-        left = std::make_unique<BinaryExpr>(op, std::move(left), std::move(right));
-    }
-    return left;
+ArenaPtr<ASTNode> Parser::parseExpression() {
+    return parseExpression(kAssignmentPower);
 }
 
-std::unique_ptr<ASTNode> Parser::parseAdditive() {
-    auto left = parseMultiplicative();
-    while (match(TokenType::PLUS) || match(TokenType::MINUS)) {
-        std::string op = previous().text();
-        auto right = parseMultiplicative();
-        left = std::make_unique<BinaryExpr>(op, std::move(left), std::move(right));
-    }
-    return left;
-}
-
-std::unique_ptr<ASTNode> Parser::parseMultiplicative() {
+ArenaPtr<ASTNode> Parser::parseExpression(int minPower) {
     auto left = parseUnary();
-    while (match(TokenType::STAR) || match(TokenType::SLASH) || match(TokenType::PERCENT)) {
-        std::string op = previous().text();
-        auto right = parseUnary();
-        left = std::make_unique<BinaryExpr>(op, std::move(left), std::move(right));
+    while (true) {
+        BindingPower power = kBindingPowers[static_cast<size_t>(current.type())];
+        if (power.left == 0 || power.left < minPower) break;
+
+        if (match(TokenType::QUESTION)) {
+            auto thenExpr = parseExpression(kCommaPower);
+            expect(TokenType::COLON, ParseDiag::ExpectedColonInTernaryExpression);
+            auto elseExpr = parseExpression(power.right);
+            left = arena.make<TernaryExpr>(std::move(left), std::move(thenExpr), std::move(elseExpr));
+            continue;
+        }
+        if ((check(TokenType::LESS_LESS) || check(TokenType::GREATER_GREATER)) && isStreamObject(left.get())) {
+            left = parseStreamExpr(std::move(left));
+            continue;
+        }
+
+        std::string op = current.text();
+        advance();
+        auto right = parseExpression(power.right);
+        left = arena.make<BinaryExpr>(std::move(op), std::move(left), std::move(right));
     }
     return left;
 }
 
-std::unique_ptr<ASTNode> Parser::parseUnary() {
-    if (match(TokenType::EXCLAIM) || match(TokenType::MINUS) || match(TokenType::INCREMENT) || match(TokenType::DECREMENT)) {
-        std::string op = previous().text();
-        auto right = parseUnary();
-        return std::make_unique<UnaryExpr>(op, std::move(right));
+ArenaPtr<ASTNode> Parser::parseUnary() {
+    if (isPrefixOperator(current.type())) {
+        std::string op = current.text();
+        advance();
+        auto operand = parseExpression(kPrefixPower);
+        return arena.make<UnaryExpr>(std::move(op), std::move(operand), true);
     }
-    return parsePostfix();
+    return parsePostfix(parsePrimary());
 }
 
-std::unique_ptr<ASTNode> Parser::parsePostfix() {
-    auto expr = parsePrimary();
+ArenaPtr<ASTNode> Parser::parsePostfix(ArenaPtr<ASTNode> expr) {
     while (true) {
-        if (match(TokenType::LEFT_PAREN)) {
+        if (check(TokenType::LEFT_PAREN)) {
             expr = parseFunctionCallSuffix(std::move(expr));
         } else if (match(TokenType::LEFT_BRACKET)) {
-            auto index = parseExpression();
-            expect(TokenType::RIGHT_BRACKET, "Expected ']' after array index");
-            expr = std::make_unique<ArrayAccess>(std::move(expr), std::move(index));
+            auto index = parseExpression(kCommaPower);
+            expect(TokenType::RIGHT_BRACKET, ParseDiag::ExpectedRBracketAfterArrayIndex);
+            expr = arena.make<ArrayAccess>(std::move(expr), std::move(index));
         } else if (match(TokenType::DOT) || match(TokenType::ARROW)) {
             std::string memberOp = previous().text();
-            expect(TokenType::IDENTIFIER, "Expected member name after '.' or '->'");
+            expect(TokenType::IDENTIFIER, ParseDiag::ExpectedMemberNameAfterDotOrArrow);
             std::string member = previous().text();
-            expr = std::make_unique<MemberAccess>(std::move(expr), member, memberOp == "->");
+            expr = arena.make<MemberAccess>(std::move(expr), member, memberOp == "->");
         } else if (match(TokenType::SCOPE)) {
-            expect(TokenType::IDENTIFIER, "Expected identifier after '::'");
-            std::string name = current.text();
-            advance();
-            expr = std::make_unique<QualifiedName>(std::move(expr), name);
+            if (!isStreamToken(current.type()) || !match(current.type())) {   // std::cout
+                expect(TokenType::IDENTIFIER, ParseDiag::ExpectedIdentifierAfterScope);
+            }
+            std::string name = previous().text();
+            expr = arena.make<QualifiedName>(std::move(expr), name);
+        } else if (match(TokenType::INCREMENT) || match(TokenType::DECREMENT)) {
+            expr = arena.make<UnaryExpr>(previous().text(), std::move(expr), false);
         } else {
             break;
         }
@@ -686,31 +1039,31 @@ std::unique_ptr<ASTNode> Parser::parsePostfix() {
 }
 
 
-std::unique_ptr<ASTNode> Parser::parseType() {
-    expect(TokenType::IDENTIFIER, "Expected type name");
+ArenaPtr<ASTNode> Parser::parseType() {
+    expect(TokenType::IDENTIFIER, ParseDiag::ExpectedTypeName);
     std::string base = previous().text(); // FIX: use previous().text()
     if (match(TokenType::LESS)) {
-        std::vector<std::unique_ptr<ASTNode>> typeArgs;
+        std::vector<ArenaPtr<ASTNode>> typeArgs;
         do {
             typeArgs.push_back(parseType());
         } while (match(TokenType::COMMA));
-        expect(TokenType::GREATER, "Expected '>' after template arguments");
-        return std::make_unique<TemplateType>(base, std::move(typeArgs));
+        expect(TokenType::GREATER, ParseDiag::ExpectedGreaterAfterTemplateArguments);
+        return arena.make<TemplateType>(base, std::move(typeArgs));
     }
-    return std::make_unique<Identifier>(base);
+    return arena.make<Identifier>(internName(base));
 }
 
 
-std::unique_ptr<ASTNode> Parser::parsePreprocessorDirective() {
+ArenaPtr<ASTNode> Parser::parsePreprocessorDirective() {
     if (!match(TokenType::HASH)) return nullptr;
 
     if (match(TokenType::PREPROCESSOR_INCLUDE)) {
-        expect(TokenType::STRING, "Expected header after #include");
+        expect(TokenType::STRING, ParseDiag::ExpectedHeaderAfterInclude);
         std::string header = previous().text();
-        return std::make_unique<PreprocessorInclude>(header);
+        return arena.make<PreprocessorInclude>(header);
     }
     if (match(TokenType::PREPROCESSOR_DEFINE)) {
-        expect(TokenType::IDENTIFIER, "Expected macro name after #define");
+        expect(TokenType::IDENTIFIER, ParseDiag::ExpectedMacroNameAfterDefine);
         std::string macro = previous().text();
         std::string value;
         // Optionally parse the macro value (until end of line)
@@ -718,48 +1071,48 @@ std::unique_ptr<ASTNode> Parser::parsePreprocessorDirective() {
             value = current.text();
             advance();
         }
-        return std::make_unique<PreprocessorDefine>(macro, value);
+        return arena.make<PreprocessorDefine>(macro, value);
     }
     if (match(TokenType::PREPROCESSOR_UNDEF)) {
-        expect(TokenType::IDENTIFIER, "Expected macro name after #undef");
+        expect(TokenType::IDENTIFIER, ParseDiag::ExpectedMacroNameAfterUndef);
         std::string macro = previous().text();
-        return std::make_unique<PreprocessorUndef>(macro);
+        return arena.make<PreprocessorUndef>(macro);
     }
     if (match(TokenType::PREPROCESSOR_IFDEF)) {
-        expect(TokenType::IDENTIFIER, "Expected macro name after #ifdef");
+        expect(TokenType::IDENTIFIER, ParseDiag::ExpectedMacroNameAfterIfdef);
         std::string macro = previous().text();
-        return std::make_unique<PreprocessorIfdef>(macro);
+        return arena.make<PreprocessorIfdef>(macro);
     }
     if (match(TokenType::PREPROCESSOR_IFNDEF)) {
-        expect(TokenType::IDENTIFIER, "Expected macro name after #ifndef");
+        expect(TokenType::IDENTIFIER, ParseDiag::ExpectedMacroNameAfterIfndef);
         std::string macro = previous().text();
-        return std::make_unique<PreprocessorIfndef>(macro);
+        return arena.make<PreprocessorIfndef>(macro);
     }
     if (match(TokenType::PREPROCESSOR_IF)) {
         // Optionally parse the condition as a string or expression
         std::string condition = current.text();
         advance();
-        return std::make_unique<PreprocessorIf>(condition);
+        return arena.make<PreprocessorIf>(condition);
     }
     if (match(TokenType::PREPROCESSOR_ELSE)) {
-        return std::make_unique<PreprocessorElse>();
+        return arena.make<PreprocessorElse>();
     }
     if (match(TokenType::PREPROCESSOR_ELIF)) {
         std::string condition = current.text();
         advance();
-        return std::make_unique<PreprocessorElif>(condition);
+        return arena.make<PreprocessorElif>(condition);
     }
     if (match(TokenType::PREPROCESSOR_ENDIF)) {
-        return std::make_unique<PreprocessorEndif>();
+        return arena.make<PreprocessorEndif>();
     }
     if (match(TokenType::PREPROCESSOR_PRAGMA)) {
         std::string pragma = current.text();
         advance();
-        return std::make_unique<PreprocessorPragma>(pragma);
+        return arena.make<PreprocessorPragma>(pragma);
     }
 
     // Unknown or unsupported directive
     std::string unknown = current.text();
     advance();
-    return std::make_unique<PreprocessorUnknown>(unknown);
+    return arena.make<PreprocessorUnknown>(unknown);
 }
\ No newline at end of file
@@ -4,83 +4,116 @@
 
 #include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\lexer.hpp"
 #include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\ast.hpp"
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\parse_diagnostics.hpp"
 #include <memory>
+#include <vector>
 
 class Parser {
 public:
-    explicit Parser(Lexer& lexer);
+    // Nodes are allocated from arena, which must outlive the returned tree
+    Parser(Lexer& lexer, AstArena& arena);
+    Parser(const TokenBuffer& tokens, AstArena& arena);   // Pre-lexed stream; must end with END_OF_FILE
 
-    std::unique_ptr<ASTNode> parse();
+    // Parses the whole input; errors do not stop the parse. The tree is only
+    // meaningful when diagnostics() is empty (broken spots hold null nodes).
+    ArenaPtr<ASTNode> parse();
+
+    // Same result as parse(), but top-level declarations are parsed on worker
+    // threads (0 = one per hardware thread). Needs a parser built on a
+    // TokenBuffer that has not started; anything else, or a small input,
+    // falls back to parse().
+    static constexpr size_t kParallelMinTokens = 1 << 16;
+    ArenaPtr<ASTNode> parseParallel(unsigned threadCount = 0);
+
+    const std::vector<Diagnostic>& diagnostics() const { return errors; }
+    bool hadError() const { return !errors.empty(); }
 
 private:
-    Lexer& lexer;
+    AstArena& arena;
+    Lexer* lexer = nullptr;               // Streaming mode: tokens pulled on demand
+    const TokenBuffer* tokens = nullptr;  // Buffer mode: lookahead reads the type column
+    size_t nextIndex = 0;                 // Buffer mode: index of the token after current
+    size_t endIndex = 0;                  // Buffer mode: reads as END_OF_FILE from here on
     Token current;
     Token prev;
+    std::vector<Diagnostic> errors;       // In source order
+    bool panicMode = false;               // An error is pending recovery; further errors are dropped
+    size_t consumed = 0;                  // Tokens advanced past so far
+    size_t errorAt = 0;                   // consumed when the pending error was reported
+    bool concurrent = false;              // A parseParallel worker: other workers intern alongside
+    bool started = false;                 // parse() or parseParallel() has run
+
+    // Buffer mode over tokens [begin, end): one range of parseParallel()
+    Parser(const TokenBuffer& tokens, AstArena& arena, size_t begin, size_t end);
 
     void advance();
+    TokenType peekType(size_t k);   // Type of the k-th token after current (k < Lexer::kMaxLookahead)
     bool match(TokenType type);
     bool check(TokenType type);
-    bool expect(TokenType type, const std::string& errMsg);
+    bool expect(TokenType type, ParseDiag diag);   // Reports diag and returns false on a mismatch
+    void report(ParseDiag diag);                    // Records an error at the current token
+    void synchronize();                             // Ends panic mode at the next ';' or '}'
+    void recover(size_t start);                     // After a list element; ensures progress
+    Symbol symbolOf(const Token& token);            // The token's Symbol, interning it if the lexer did not
+    Symbol internName(std::string_view spelling);   // intern(), or internShared() when concurrent
     bool isAtEnd() ; // Returns true if current token is END_OF_FILE
     Token previous(); // Returns the previous token (if you keep track)
     // Top-level rules
-    std::unique_ptr<Program> parseProgram();
-    std::unique_ptr<ASTNode> parseDeclaration();
+    ArenaPtr<Program> parseProgram();
+    ArenaPtr<ASTNode> parseDeclaration();
     
-    std::unique_ptr<ASTNode> parseType();
+    ArenaPtr<ASTNode> parseType();
 
     // Declarations
-    std::unique_ptr<ASTNode> parseFunctionDecl();
-    std::unique_ptr<ASTNode> parseClassDecl();
-    std::unique_ptr<ASTNode> parseStructDecl();
-    std::unique_ptr<ASTNode> parseEnumDecl();
-    std::unique_ptr<ASTNode> parseUnionDecl();
-    std::unique_ptr<ASTNode> parseNamespaceDecl();
-    std::unique_ptr<ASTNode> parseVariableDecl();
-    std::unique_ptr<ASTNode> parseTypedefDecl();
-    std::unique_ptr<ASTNode> parseUsingDirective();
-    std::unique_ptr<ASTNode> parsePreprocessorDirective();
+    ArenaPtr<ASTNode> parseFunctionDecl();
+    ArenaPtr<ASTNode> parseClassDecl();
+    ArenaPtr<ASTNode> parseStructDecl();
+    ArenaPtr<ASTNode> parseEnumDecl();
+    ArenaPtr<ASTNode> parseUnionDecl();
+    ArenaPtr<ASTNode> parseNamespaceDecl();
+    ArenaPtr<ASTNode> parseVariableDecl();
+    ArenaPtr<ASTNode> parseTypedefDecl();
+    ArenaPtr<ASTNode> parseUsingDirective();
+    ArenaPtr<ASTNode> parsePreprocessorDirective();
 
     // Statements
-    std::unique_ptr<ASTNode> parseStatement();
-    std::unique_ptr<ASTNode> parseBlock();
-    std::unique_ptr<ASTNode> parseIfStmt();
-    std::unique_ptr<ASTNode> parseElseStmt();
-    std::unique_ptr<ASTNode> parseSwitchStmt();
-    std::unique_ptr<ASTNode> parseCaseStmt();
-    std::unique_ptr<ASTNode> parseDefaultStmt();
-    std::unique_ptr<ASTNode> parseWhileStmt();
-    std::unique_ptr<ASTNode> parseDoWhileStmt();
-    std::unique_ptr<ASTNode> parseForStmt();
-    std::unique_ptr<ASTNode> parseReturnStmt();
-    std::unique_ptr<ASTNode> parseBreakStmt();
-    std::unique_ptr<ASTNode> parseContinueStmt();
-    std::unique_ptr<ASTNode> parseGotoStmt();
-    std::unique_ptr<ASTNode> parseTryStmt();
-    std::unique_ptr<ASTNode> parseCatchStmt();
-    std::unique_ptr<ASTNode> parseThrowStmt();
+    ArenaPtr<ASTNode> parseStatement();
+    ArenaPtr<ASTNode> parseBlock();
+    ArenaPtr<ASTNode> parseIfStmt();
+    ArenaPtr<ASTNode> parseElseStmt();
+    ArenaPtr<ASTNode> parseSwitchStmt();
+    ArenaPtr<ASTNode> parseCaseStmt();
+    ArenaPtr<ASTNode> parseDefaultStmt();
+    ArenaPtr<ASTNode> parseWhileStmt();
+    ArenaPtr<ASTNode> parseDoWhileStmt();
+    ArenaPtr<ASTNode> parseForStmt();
+    ArenaPtr<ASTNode> parseReturnStmt();
+    ArenaPtr<ASTNode> parseBreakStmt();
+    ArenaPtr<ASTNode> parseContinueStmt();
+    ArenaPtr<ASTNode> parseGotoStmt();
+    ArenaPtr<ASTNode> parseTryStmt();
+    ArenaPtr<ASTNode> parseCatchStmt();
+    ArenaPtr<ASTNode> parseThrowStmt();
 
     // Expressions
-    std::unique_ptr<ASTNode> parseExpression();
-    std::unique_ptr<ASTNode> parseTernary();
-    std::unique_ptr<ASTNode> parseLogicalOr();
-    std::unique_ptr<ASTNode> parseLogicalAnd();
-    std::unique_ptr<ASTNode> parseEquality();
-    std::unique_ptr<ASTNode> parseRelational();
-    std::unique_ptr<ASTNode> parseAdditive();
-    std::unique_ptr<ASTNode> parseMultiplicative();
-    std::unique_ptr<ASTNode> parseUnary();
-    std::unique_ptr<ASTNode> parsePostfix();
-    std::unique_ptr<ASTNode> parsePrimary();
+    ArenaPtr<ASTNode> parseExpression();                 // Assignment-expression (no top-level comma)
+    ArenaPtr<ASTNode> parseExpression(int minPower);     // Operators binding at least minPower
+    ArenaPtr<ASTNode> parseUnary();                      // Prefix operators, then a postfix chain
+    ArenaPtr<ASTNode> parsePostfix(ArenaPtr<ASTNode> expr);
+    ArenaPtr<ASTNode> parsePrimary();
 
     // Specialized constructs
-    std::unique_ptr<ASTNode> parseStreamExpr();
-    std::unique_ptr<ASTNode> parseFunctionCallSuffix(std::unique_ptr<ASTNode> callee);
-    std::unique_ptr<ASTNode> parseTemplateTypeSuffix(std::string baseName);
+    ArenaPtr<ASTNode> parseStreamExpr(ArenaPtr<ASTNode> stream);   // stream is already parsed
+    ArenaPtr<ASTNode> parseFunctionCallSuffix(ArenaPtr<ASTNode> callee);
+    ArenaPtr<ASTNode> parseTemplateTypeSuffix(std::string baseName);
 
     // Helpers
     bool isTypeToken(TokenType type);
     std::string tokenToString(TokenType type);
 };
 
+// One line for a diagnostic, "file:line:col: message (found TYPE)", with the
+// position looked up in the lexer that produced the parsed tokens
+std::string formatDiagnostic(const Diagnostic& diag, const Lexer& lexer);
+
 #endif // PARSER_HPP
\ No newline at end of file
@@ -0,0 +1,142 @@
+#ifndef PUNCTUATORS_HPP
+#define PUNCTUATORS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\tokens.hpp"
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\char_class.hpp"
+
+// Operator and punctuation spellings recognized by the lexer. This list is
+// the single source of truth: the recognizer below is generated from it at
+// compile time, so adding a punctuator is one line here (plus its TokenType).
+// "##" is deliberately absent: macro bodies see it as two adjacent HASH tokens.
+struct PunctuatorEntry {
+    std::string_view spelling;
+    TokenType type;
+};
+
+inline constexpr PunctuatorEntry kPunctuators[] = {
+    {"+", TokenType::PLUS}, {"++", TokenType::INCREMENT}, {"+=", TokenType::PLUS_EQUAL},
+    {"-", TokenType::MINUS}, {"--", TokenType::DECREMENT}, {"-=", TokenType::MINUS_EQUAL},
+    {"->", TokenType::ARROW}, {"->*", TokenType::ARROW_STAR},
+    {"*", TokenType::STAR}, {"*=", TokenType::STAR_EQUAL},
+    {"/", TokenType::SLASH}, {"/=", TokenType::SLASH_EQUAL},
+    {"%", TokenType::PERCENT}, {"%=", TokenType::PERCENT_EQUAL},
+    {"=", TokenType::EQUAL}, {"==", TokenType::EQUAL_EQUAL},
+    {"!", TokenType::EXCLAIM}, {"!=", TokenType::NOT_EQUAL},
+    {"<", TokenType::LESS}, {"<=", TokenType::LESS_EQUAL}, {"<=>", TokenType::SPACESHIP},
+    {"<<", TokenType::LESS_LESS}, {"<<=", TokenType::LEFT_SHIFT_EQUAL},
+    {">", TokenType::GREATER}, {">=", TokenType::GREATER_EQUAL},
+    {">>", TokenType::GREATER_GREATER}, {">>=", TokenType::RIGHT_SHIFT_EQUAL},
+    {"&", TokenType::AMPERSAND}, {"&&", TokenType::AND_AND}, {"&=", TokenType::AND_EQUAL},
+    {"|", TokenType::PIPE}, {"||", TokenType::OR_OR}, {"|=", TokenType::OR_EQUAL},
+    {"^", TokenType::CARET}, {"^=", TokenType::XOR_EQUAL},
+    {"~", TokenType::TILDE}, {"?", TokenType::QUESTION},
+    {":", TokenType::COLON}, {"::", TokenType::SCOPE},
+    {".", TokenType::DOT}, {".*", TokenType::DOT_STAR}, {"...", TokenType::ELLIPSIS},
+    {";", TokenType::SEMICOLON}, {",", TokenType::COMMA},
+    {"(", TokenType::LEFT_PAREN}, {")", TokenType::RIGHT_PAREN},
+    {"{", TokenType::LEFT_BRACE}, {"}", TokenType::RIGHT_BRACE},
+    {"[", TokenType::LEFT_BRACKET}, {"]", TokenType::RIGHT_BRACKET},
+    {"#", TokenType::HASH},
+};
+
+inline constexpr size_t kPunctuatorCount = sizeof(kPunctuators) / sizeof(kPunctuators[0]);
+
+// --- Compile-time maximal-munch DFA ---
+// The spellings are folded into a trie whose states form a transition table
+// indexed by (state, byte class). Bytes that occur in no punctuator share
+// class 0, whose column is all "no transition", so the table stays a few
+// hundred bytes. Recognition walks the table once, remembering the last
+// accepting state, which gives the longest match with backtracking for
+// inputs like ".." (two DOTs) or "->" followed by something other than '*'.
+namespace punctuator_detail {
+
+constexpr size_t kMaxStates = 64;
+constexpr size_t kMaxClasses = 32;
+
+struct Dfa {
+    uint8_t byteClass[256] = {};                       // 0 = not part of any punctuator
+    uint8_t next[kMaxStates][kMaxClasses] = {};        // 0 = no transition (0 is the start state)
+    TokenType accept[kMaxStates] = {};                 // ERROR = not an accepting state
+    size_t stateCount = 1;
+    size_t classCount = 1;
+    bool valid = true;                                 // False on overflow or a duplicate spelling
+};
+
+constexpr Dfa buildDfa() {
+    Dfa dfa;
+    for (size_t s = 0; s < kMaxStates; ++s) dfa.accept[s] = TokenType::ERROR;
+
+    for (size_t i = 0; i < kPunctuatorCount; ++i) {
+        for (char c : kPunctuators[i].spelling) {
+            uint8_t& cls = dfa.byteClass[static_cast<unsigned char>(c)];
+            if (cls != 0) continue;
+            if (dfa.classCount == kMaxClasses) { dfa.valid = false; return dfa; }
+            cls = static_cast<uint8_t>(dfa.classCount++);
+        }
+    }
+
+    for (size_t i = 0; i < kPunctuatorCount; ++i) {
+        size_t state = 0;
+        for (char c : kPunctuators[i].spelling) {
+            uint8_t cls = dfa.byteClass[static_cast<unsigned char>(c)];
+            if (dfa.next[state][cls] == 0) {
+                if (dfa.stateCount == kMaxStates) { dfa.valid = false; return dfa; }
+                dfa.next[state][cls] = static_cast<uint8_t>(dfa.stateCount++);
+            }
+            state = dfa.next[state][cls];
+        }
+        if (state == 0 || dfa.accept[state] != TokenType::ERROR) { dfa.valid = false; return dfa; }
+        dfa.accept[state] = kPunctuators[i].type;
+    }
+    return dfa;
+}
+
+inline constexpr Dfa kDfa = buildDfa();
+
+static_assert(kDfa.valid, "punctuator table overflows the DFA or repeats a spelling");
+
+constexpr bool firstBytesAreOperatorStarts() {
+    for (size_t i = 0; i < kPunctuatorCount; ++i) {
+        if (!charclass::isOperatorStart(kPunctuators[i].spelling[0])) return false;
+    }
+    return true;
+}
+
+static_assert(firstBytesAreOperatorStarts(), "charclass::OperatorStart is missing a punctuator's first byte");
+
+} // namespace punctuator_detail
+
+struct PunctuatorMatch {
+    size_t length;     // 0 if no punctuator starts here
+    TokenType type;    // ERROR if length is 0
+};
+
+// Longest punctuator starting at p (never reads at or past end)
+constexpr PunctuatorMatch matchPunctuator(const char* p, const char* end) {
+    using namespace punctuator_detail;
+    PunctuatorMatch best{0, TokenType::ERROR};
+    size_t state = 0;
+    for (const char* q = p; q < end; ++q) {
+        state = kDfa.next[state][kDfa.byteClass[static_cast<unsigned char>(*q)]];
+        if (state == 0) break;
+        if (kDfa.accept[state] != TokenType::ERROR) {
+            best = PunctuatorMatch{static_cast<size_t>(q - p) + 1, kDfa.accept[state]};
+        }
+    }
+    return best;
+}
+
+constexpr PunctuatorMatch matchPunctuator(std::string_view text) {
+    return matchPunctuator(text.data(), text.data() + text.size());
+}
+
+static_assert(matchPunctuator("<<=x").type == TokenType::LEFT_SHIFT_EQUAL, "punctuator DFA out of sync");
+static_assert(matchPunctuator("<=>").type == TokenType::SPACESHIP, "punctuator DFA out of sync");
+static_assert(matchPunctuator("->*").length == 3, "punctuator DFA out of sync");
+static_assert(matchPunctuator("..").type == TokenType::DOT, "punctuator DFA out of sync");
+static_assert(matchPunctuator("@").length == 0, "punctuator DFA out of sync");
+
+#endif // PUNCTUATORS_HPP
@@ -0,0 +1,166 @@
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\source_buffer.hpp"
+#include <cstdio>
+#include <utility>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// === Lifetime ===
+
+SourceBuffer::~SourceBuffer() {
+    close();
+}
+
+SourceBuffer::SourceBuffer(SourceBuffer&& other) noexcept {
+    *this = std::move(other);
+}
+
+SourceBuffer& SourceBuffer::operator=(SourceBuffer&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, "");
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+        owned_ = std::move(other.owned_);
+#ifdef _WIN32
+        fileHandle_ = std::exchange(other.fileHandle_, nullptr);
+        mappingHandle_ = std::exchange(other.mappingHandle_, nullptr);
+#endif
+    }
+    return *this;
+}
+
+bool SourceBuffer::open(const std::string& path) {
+    close();
+    if (mapFile(path)) return true;
+    return readFile(path);
+}
+
+void SourceBuffer::close() {
+    if (mapped_) {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(static_cast<HANDLE>(mappingHandle_));
+        CloseHandle(static_cast<HANDLE>(fileHandle_));
+        mappingHandle_ = nullptr;
+        fileHandle_ = nullptr;
+#else
+        munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+    owned_.reset();
+    data_ = "";
+    size_ = 0;
+    mapped_ = false;
+}
+
+// === Memory mapping ===
+
+#ifdef _WIN32
+
+bool SourceBuffer::mapFile(const std::string& path) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        // Empty files cannot be mapped; let the read path handle them
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    data_ = static_cast<const char*>(view);
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    mapped_ = true;
+    fileHandle_ = file;
+    mappingHandle_ = mapping;
+    return true;
+}
+
+#else
+
+bool SourceBuffer::mapFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        // Empty files and non-regular files cannot be mapped; let the read path handle them
+        ::close(fd);
+        return false;
+    }
+
+    size_t length = static_cast<size_t>(st.st_size);
+    void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // The mapping keeps its own reference to the file
+    if (addr == MAP_FAILED) return false;
+
+#ifdef MADV_SEQUENTIAL
+    madvise(addr, length, MADV_SEQUENTIAL);
+#endif
+
+    data_ = static_cast<const char*>(addr);
+    size_ = length;
+    mapped_ = true;
+    return true;
+}
+
+#endif
+
+// === Read fallback ===
+
+bool SourceBuffer::readFile(const std::string& path) {
+    // Regular files only: a directory opens on some platforms, and ftell()
+    // then reports a meaningless length
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || (st.st_mode & S_IFMT) != S_IFREG) return false;
+
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    // Size the buffer once from the file length, then read it in one go
+    long length = -1;
+    if (std::fseek(file, 0, SEEK_END) == 0) {
+        length = std::ftell(file);
+        if (std::fseek(file, 0, SEEK_SET) != 0) length = -1;
+    }
+    if (length < 0) {
+        std::fclose(file);
+        return false;
+    }
+
+    size_t expected = static_cast<size_t>(length);
+    owned_ = std::make_unique<char[]>(expected + 1);
+    bool complete = std::fread(owned_.get(), 1, expected, file) == expected && !std::ferror(file);
+    std::fclose(file);
+    if (!complete) {   // Read error, or the file shrank under us
+        owned_.reset();
+        return false;
+    }
+
+    data_ = owned_.get();
+    size_ = expected;
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef SOURCE_BUFFER_HPP
+#define SOURCE_BUFFER_HPP
+
+#include <string>
+#include <string_view>
+#include <memory>
+
+// Read-only, contiguous view of a source file.
+//
+// The file is memory-mapped when the platform allows it (with a sequential
+// access hint), otherwise it is read once into a buffer sized from the file
+// length. Either way there is no intermediate copy: view() can be handed
+// straight to Lexer.
+class SourceBuffer {
+public:
+    SourceBuffer() = default;
+    ~SourceBuffer();
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+    SourceBuffer(SourceBuffer&& other) noexcept;
+    SourceBuffer& operator=(SourceBuffer&& other) noexcept;
+
+    // Load the file at path. Returns false (and leaves the buffer empty) on failure.
+    bool open(const std::string& path);
+    void close();
+
+    std::string_view view() const { return std::string_view(data_, size_); }
+    size_t size() const { return size_; }
+    bool isMapped() const { return mapped_; }
+
+private:
+    bool mapFile(const std::string& path);   // Memory-map path; false if mapping is unavailable
+    bool readFile(const std::string& path);  // Fallback: one pre-sized read
+
+    const char* data_ = "";
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::unique_ptr<char[]> owned_;   // Backing storage when the file was read, not mapped
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+};
+
+#endif // SOURCE_BUFFER_HPP
@@ -0,0 +1,52 @@
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\symbol.hpp"
+
+SymbolInterner::SymbolInterner() {
+    for (auto& block : blocks_) block.store(nullptr, std::memory_order_relaxed);
+    ids_.reserve(1024);
+    append(std::string_view());   // ID 0: the empty spelling
+}
+
+SymbolInterner::~SymbolInterner() {
+    for (auto& block : blocks_) delete[] block.load(std::memory_order_relaxed);
+}
+
+SymbolInterner& SymbolInterner::global() {
+    static SymbolInterner interner;
+    return interner;
+}
+
+Symbol SymbolInterner::intern(std::string_view spelling) {
+    if (spelling.empty()) return Symbol();
+
+    auto it = ids_.find(spelling);
+    if (it != ids_.end()) return Symbol(it->second);
+
+    std::string_view stored = storage_.copy(spelling);
+    uint32_t id = append(stored);
+    ids_.emplace(stored, id);
+    return Symbol(id);
+}
+
+Symbol SymbolInterner::internShared(std::string_view spelling) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return intern(spelling);
+}
+
+Symbol SymbolInterner::find(std::string_view spelling) const {
+    auto it = ids_.find(spelling);
+    return it != ids_.end() ? Symbol(it->second) : Symbol();
+}
+
+uint32_t SymbolInterner::append(std::string_view stored) {
+    uint32_t id = count_.load(std::memory_order_relaxed);
+    size_t n = id + kFirstBlockSize;
+    size_t block = floorLog2(n) - kFirstBlockBits;
+    std::string_view* entries = blocks_[block].load(std::memory_order_relaxed);
+    if (!entries) {
+        entries = new std::string_view[kFirstBlockSize << block];
+        blocks_[block].store(entries, std::memory_order_release);
+    }
+    entries[n - (kFirstBlockSize << block)] = stored;
+    count_.store(id + 1, std::memory_order_release);
+    return id;
+}
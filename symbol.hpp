@@ -0,0 +1,125 @@
+#ifndef SYMBOL_HPP
+#define SYMBOL_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\arena.hpp"
+
+// Interned identifier spelling.
+//
+// Every distinct spelling is stored once, in the process-wide interner, and
+// named by a 32-bit ID; the lexer, the parser and the code generator all pass
+// those IDs around instead of copying strings, so comparing two names or
+// hashing one is an integer operation. ID 0 is the empty spelling ("no
+// symbol"). Spellings are never freed, so a view obtained from a Symbol stays
+// valid for the rest of the run.
+class Symbol {
+public:
+    constexpr Symbol() : id_(0) {}
+    constexpr explicit Symbol(uint32_t id) : id_(id) {}
+
+    constexpr uint32_t id() const { return id_; }
+    constexpr bool empty() const { return id_ == 0; }
+
+    std::string_view view() const;                          // Spelling, from the interner
+    std::string str() const { return std::string(view()); } // Materializes a copy
+
+    constexpr bool operator==(Symbol other) const { return id_ == other.id_; }
+    constexpr bool operator!=(Symbol other) const { return id_ != other.id_; }
+    constexpr bool operator<(Symbol other) const { return id_ < other.id_; }   // Interning order, not alphabetical
+
+private:
+    uint32_t id_;
+};
+
+inline std::ostream& operator<<(std::ostream& os, Symbol symbol) {
+    return os << symbol.view();
+}
+
+namespace std {
+template <>
+struct hash<Symbol> {
+    size_t operator()(Symbol symbol) const noexcept { return symbol.id(); }
+};
+} // namespace std
+
+// Spelling <-> ID table backing Symbol. Spellings are copied into an arena
+// that is never reset, so views stay stable as it grows.
+//
+// intern() and find() take no lock: the lexer interns every identifier from
+// one thread. Threads that intern at the same time (parseParallel's
+// workers) use internShared() instead, which serializes on a mutex, and
+// nothing may call intern() meanwhile. spelling() is safe during either:
+// IDs index a table of blocks that double in size and never move once
+// allocated, so a reader holding a Symbol can look it up while another
+// thread adds spellings. (A Symbol only reaches a thread through intern()
+// or some other synchronized hand-off, which orders the entry's write
+// before the read.)
+class SymbolInterner {
+public:
+    SymbolInterner();
+    SymbolInterner(const SymbolInterner&) = delete;
+    SymbolInterner& operator=(const SymbolInterner&) = delete;
+    ~SymbolInterner();
+
+    static SymbolInterner& global();   // The table every Symbol refers to
+
+    Symbol intern(std::string_view spelling);            // Adds the spelling if it is new
+    Symbol internShared(std::string_view spelling);      // intern(), safe against other internShared() calls
+    Symbol find(std::string_view spelling) const;        // Empty Symbol if never interned
+    std::string_view spelling(Symbol symbol) const {
+        size_t n = symbol.id() + kFirstBlockSize;
+        size_t block = floorLog2(n) - kFirstBlockBits;
+        return blocks_[block].load(std::memory_order_acquire)[n - (kFirstBlockSize << block)];
+    }
+
+    size_t size() const { return count_.load(std::memory_order_acquire) - 1; }   // Distinct non-empty spellings
+    size_t bytesUsed() const { return storage_.bytesUsed(); }                    // Spelling bytes stored
+
+private:
+    // Block b holds IDs [kFirstBlockSize * (2^b - 1), kFirstBlockSize * (2^(b+1) - 1))
+    static constexpr size_t kFirstBlockBits = 10;
+    static constexpr size_t kFirstBlockSize = size_t(1) << kFirstBlockBits;
+    static constexpr size_t kMaxBlocks = 32 - kFirstBlockBits + 1;   // Enough for every 32-bit ID
+
+    static size_t floorLog2(size_t n) {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanReverse64(&index, n);
+        return index;
+#else
+        return 63 - static_cast<size_t>(__builtin_clzll(n));
+#endif
+    }
+
+    std::mutex mutex_;                                          // Held by internShared()
+    Arena storage_;
+    std::array<std::atomic<std::string_view*>, kMaxBlocks> blocks_;   // Indexed by ID; [0][0] is ""
+    std::atomic<uint32_t> count_{0};                           // IDs handed out, including 0
+    std::unordered_map<std::string_view, uint32_t> ids_;       // Keys view into storage_
+
+    uint32_t append(std::string_view stored);                  // Caller is the only writer
+};
+
+// Shorthand for SymbolInterner::global().intern()
+inline Symbol intern(std::string_view spelling) {
+    return SymbolInterner::global().intern(spelling);
+}
+
+inline std::string_view Symbol::view() const {
+    return SymbolInterner::global().spelling(*this);
+}
+
+#endif // SYMBOL_HPP
@@ -0,0 +1,108 @@
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\token_buffer.hpp"
+#include <algorithm>
+#include <iterator>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+size_t token_buffer_detail::popcount64(uint64_t bits) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<size_t>(__popcnt64(bits));
+#else
+    return static_cast<size_t>(__builtin_popcountll(bits));
+#endif
+}
+
+TokenBuffer::TokenBuffer(std::string_view source, const IncludeResolver* includes)
+    : source_(source), includes_(includes) {}
+
+void TokenBuffer::reserve(size_t count) {
+    types_.reserve(count);
+    offsets_.reserve(count);
+    lengths_.reserve(count);
+}
+
+void TokenBuffer::push_back(const Token& token) {
+    size_t index = types_.size();
+    types_.push_back(static_cast<uint8_t>(token.type()));
+    offsets_.push_back(token.offset());
+    size_t length = token.view().size();
+    bool longText = length >= kLongLength;
+    lengths_.push_back(static_cast<uint16_t>(longText ? kLongLength : length));
+
+    uint16_t previousFile = fileRuns_.empty() ? 0 : fileRuns_.back().file;
+    if (token.file() != previousFile) {
+        fileRuns_.push_back(FileRun{static_cast<uint32_t>(index), token.file()});
+    }
+
+    if (!token.symbol().empty()) {
+        symbols_.add(index, token.symbol());
+    }
+
+    const char* fileBase = base(token.file());
+    bool textAtOffset = fileBase && token.view().data() == fileBase + token.offset();
+    if (!textAtOffset || longText || token.is_float() || token.int_value() != 0 || token.has_escape()) {
+        Extra extra{};
+        extra.text = textAtOffset ? nullptr : token.view().data();
+        extra.length = static_cast<uint32_t>(length);
+        if (token.is_float()) extra.floatValue = token.float_value();
+        else extra.intValue = token.int_value();
+        extra.isFloat = token.is_float();
+        extra.hasEscape = token.has_escape();
+        extras_.add(index, extra);
+    }
+}
+
+void TokenBuffer::clear() {
+    types_.clear();
+    offsets_.clear();
+    lengths_.clear();
+    symbols_.clear();
+    extras_.clear();
+    fileRuns_.clear();
+}
+
+uint16_t TokenBuffer::file(size_t i) const {
+    auto it = std::upper_bound(fileRuns_.begin(), fileRuns_.end(), i,
+                               [](size_t index, const FileRun& run) { return index < run.first; });
+    return it == fileRuns_.begin() ? 0 : std::prev(it)->file;
+}
+
+uint32_t TokenBuffer::length(size_t i) const {
+    if (lengths_[i] != kLongLength) return lengths_[i];
+    return extras_.find(i)->length;
+}
+
+std::string_view TokenBuffer::view(size_t i) const {
+    const Extra* extra = extras_.find(i);
+    const char* text = (extra && extra->text) ? extra->text : base(file(i)) + offsets_[i];
+    uint32_t length = lengths_[i] != kLongLength ? lengths_[i] : extra->length;
+    return std::string_view(text, length);
+}
+
+Token TokenBuffer::operator[](size_t i) const {
+    Token token(type(i), view(i), offsets_[i]);
+    token.set_file(file(i));
+    if (const Symbol* symbol = symbols_.find(i)) {
+        token.set_symbol(*symbol);
+    }
+    if (const Extra* extra = extras_.find(i)) {
+        if (extra->isFloat) token.set_float_value(extra->floatValue);
+        else token.set_int_value(extra->intValue);
+        token.set_has_escape(extra->hasEscape);
+    }
+    return token;
+}
+
+size_t TokenBuffer::bytesUsed() const {
+    return types_.capacity() * sizeof(uint8_t) + offsets_.capacity() * sizeof(uint32_t) +
+           lengths_.capacity() * sizeof(uint16_t) + symbols_.bytesUsed() + extras_.bytesUsed() +
+           fileRuns_.capacity() * sizeof(FileRun);
+}
+
+const char* TokenBuffer::base(uint16_t file) const {
+    if (file == 0) return source_.data();
+    const SourceFile* source = includes_ ? includes_->file(file) : nullptr;
+    return source ? source->buffer.view().data() : nullptr;
+}
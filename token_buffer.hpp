@@ -0,0 +1,125 @@
+#ifndef TOKEN_BUFFER_HPP
+#define TOKEN_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\tokens.hpp"
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\include_resolver.hpp"
+
+namespace token_buffer_detail {
+
+size_t popcount64(uint64_t bits);
+
+// Values for a sparse subset of token indices. A bitmap marks which indices
+// have one, and a running count per 64-bit word turns "index" into a slot
+// in values_ with one popcount, so an absent entry costs about 0.2 bytes.
+// Entries must be added in increasing index order.
+template <typename T>
+class SparseColumn {
+public:
+    void add(size_t index, const T& value) {
+        size_t word = index / 64;
+        while (bits_.size() <= word) {
+            ranks_.push_back(static_cast<uint32_t>(values_.size()));
+            bits_.push_back(0);
+        }
+        bits_[word] |= uint64_t(1) << (index % 64);
+        values_.push_back(value);
+    }
+
+    const T* find(size_t index) const {
+        size_t word = index / 64;
+        if (word >= bits_.size()) return nullptr;
+        uint64_t bit = uint64_t(1) << (index % 64);
+        if ((bits_[word] & bit) == 0) return nullptr;
+        return &values_[ranks_[word] + popcount64(bits_[word] & (bit - 1))];
+    }
+
+    void clear() { bits_.clear(); ranks_.clear(); values_.clear(); }
+
+    size_t bytesUsed() const {
+        return bits_.capacity() * sizeof(uint64_t) + ranks_.capacity() * sizeof(uint32_t) +
+               values_.capacity() * sizeof(T);
+    }
+
+private:
+    std::vector<uint64_t> bits_;    // One bit per token index
+    std::vector<uint32_t> ranks_;   // Entries before each word of bits_
+    std::vector<T> values_;
+};
+
+} // namespace token_buffer_detail
+
+// Token stream stored column by column ("structure of arrays").
+//
+// A std::vector<Token> spends 32 bytes per token, most of which a scan over
+// token types never reads. Here the type, offset and length each live in
+// their own dense array (7 bytes per token), so a loop that only asks
+// "what kind of token is next?" walks one byte per token. What most tokens
+// do not need is kept on the side: identifier symbols and the rare extras
+// (text that is not at the token's own offset, literal values, escape flags,
+// lengths that do not fit 16 bits) sit in sparse columns, and file ids are
+// run-length encoded since included files arrive as contiguous runs.
+//
+// Like Token, the buffer views into the source buffers (and into the Lexer
+// for synthesized text); it must not outlive them.
+class TokenBuffer {
+public:
+    // source is file 0; includes maps other file ids to their buffers
+    explicit TokenBuffer(std::string_view source = {}, const IncludeResolver* includes = nullptr);
+
+    void reserve(size_t count);
+    void push_back(const Token& token);
+    void clear();
+
+    size_t size() const { return types_.size(); }
+    bool empty() const { return types_.empty(); }
+
+    // --- Column access ---
+    TokenType type(size_t i) const { return static_cast<TokenType>(types_[i]); }
+    const uint8_t* types() const { return types_.data(); }   // Dense TokenType array, for scans
+    uint32_t offset(size_t i) const { return offsets_[i]; }
+    uint32_t length(size_t i) const;
+    uint16_t file(size_t i) const;                            // Binary search over the file runs
+    std::string_view view(size_t i) const;
+
+    Token operator[](size_t i) const;    // The full Token, rebuilt from the columns
+
+    // --- Statistics ---
+    size_t bytesUsed() const;            // Capacity of every column, in bytes
+
+private:
+    struct Extra {
+        const char* text;    // nullptr: the text starts at offset in the token's own file
+        union {
+            long long intValue;
+            double floatValue;
+        };
+        uint32_t length;     // Used when the length column holds kLongLength
+        bool isFloat;
+        bool hasEscape;
+    };
+
+    static constexpr uint16_t kLongLength = UINT16_MAX;
+
+    struct FileRun {
+        uint32_t first;      // Index of the run's first token
+        uint16_t file;
+    };
+
+    std::string_view source_;
+    const IncludeResolver* includes_;
+
+    std::vector<uint8_t> types_;
+    std::vector<uint32_t> offsets_;
+    std::vector<uint16_t> lengths_;     // kLongLength: see Extra::length
+    token_buffer_detail::SparseColumn<Symbol> symbols_;
+    token_buffer_detail::SparseColumn<Extra> extras_;
+    std::vector<FileRun> fileRuns_;      // Only where the file changes; before the first run it is 0
+
+    const char* base(uint16_t file) const;   // Start of the file's buffer, or nullptr if unknown
+};
+
+#endif // TOKEN_BUFFER_HPP
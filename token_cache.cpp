@@ -0,0 +1,264 @@
+#include "D:\vs code\PROJECT\PBL_TRANSPILER\ver4\token_cache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'B', 'L', 'T', 'O', 'K', '0', '2'};   // Entry layout
+
+// Version of the lexer's output. An entry holds whatever the lexer produced
+// when it was stored, so every change to the tokens emitted for the same
+// source (kinds, splitting, text, preprocessing results) must bump this;
+// older entries then read as misses.
+//   1  First cached output
+//   2  Inactive #if regions skipped line by line
+//   3  Macros expanded from pre-lexed token lists
+//   4  One precedence climber for #if
+//   5  Punctuators from the maximal-munch DFA
+//   6  A function-like name ending an object-like expansion takes its arguments
+//   7  #if: self-referential macros count as 0; unsigned arithmetic
+//   8  Line splices in CRLF sources
+//   9  Hexadecimal integer literals
+constexpr uint64_t kLexerVersion = 9;
+
+// Entries written before the TokenType enum changed must not be decoded
+constexpr uint64_t kTokenTypeCount = static_cast<uint64_t>(TokenType::PREPROCESSOR_UNKNOWN) + 1;
+
+// Per-token flags, packed below the type in the token's first varint
+constexpr uint32_t kTextInSource = 1 << 0;   // Text is a range of the source, else inline
+constexpr uint32_t kTextAtOffset = 1 << 1;   // ...starting at the token offset (no position stored)
+constexpr uint32_t kHasEscape    = 1 << 2;
+constexpr uint32_t kIntValue     = 1 << 3;   // Non-zero int value follows
+constexpr uint32_t kFloatValue   = 1 << 4;   // Float value follows
+constexpr uint32_t kFlagBits     = 5;
+
+// --- Encoding ---
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+void putFixed64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+// --- Decoding (every read is bounds-checked; a short entry is a miss) ---
+
+struct Reader {
+    const char* p;
+    const char* end;
+    bool ok = true;
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) break;
+            uint8_t byte = static_cast<uint8_t>(*p++);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    uint64_t fixed64() {
+        if (end - p < 8) {
+            ok = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(p[i])) << (8 * i);
+        }
+        p += 8;
+        return value;
+    }
+};
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+} // unnamed namespace
+
+TokenCache::TokenCache(std::string directory)
+    : directory_(std::move(directory)) {}
+
+uint64_t TokenCache::hash(std::string_view data) {
+    uint64_t h = 14695981039346656037ull;
+    for (char c : data) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+std::string TokenCache::entryPath(uint64_t sourceHash, uint64_t macroFingerprint) const {
+    char name[40];
+    std::snprintf(name, sizeof(name), "%016llx%016llx.tok",
+                  static_cast<unsigned long long>(sourceHash),
+                  static_cast<unsigned long long>(macroFingerprint));
+    return (std::filesystem::path(directory_) / name).string();
+}
+
+// Entry layout:
+//   magic[8] | sourceHash u64 | macroFingerprint u64 | sourceSize u64 | typeCount varint
+//   tokenCount varint | inlineSize varint | inline text bytes
+//   per token: (type << kFlagBits | flags) varint, offset delta varint,
+//              text position varint (zigzag(text - offset) in source, inline
+//              offset otherwise; omitted if kTextAtOffset), length varint,
+//              value: zigzag varint (int) or fixed64 bits (float)
+bool TokenCache::store(std::string_view source, uint64_t macroFingerprint,
+                       const std::vector<Token>& tokens) const {
+    uint64_t sourceHash = hash(source);
+    const char* base = source.data();
+
+    std::string inlineText;
+    std::string body;
+    body.reserve(tokens.size() * 6);
+    uint32_t prevOffset = 0;
+    for (const Token& token : tokens) {
+        std::string_view text = token.view();
+        bool inSource = text.data() >= base && text.data() + text.size() <= base + source.size();
+
+        uint32_t flags = 0;
+        if (inSource) flags |= kTextInSource;
+        if (inSource && text.data() == base + token.offset()) flags |= kTextAtOffset;
+        if (token.has_escape()) flags |= kHasEscape;
+        if (token.is_float()) flags |= kFloatValue;
+        else if (token.int_value() != 0) flags |= kIntValue;
+
+        putVarint(body, (static_cast<uint64_t>(token.type()) << kFlagBits) | flags);
+        putVarint(body, token.offset() - prevOffset);
+        prevOffset = token.offset();
+
+        if (!inSource) {
+            putVarint(body, inlineText.size());
+            inlineText.append(text);
+        } else if (!(flags & kTextAtOffset)) {
+            putVarint(body, zigzag(static_cast<int64_t>(text.data() - base) - token.offset()));
+        }
+        putVarint(body, text.size());
+
+        if (flags & kIntValue) {
+            putVarint(body, zigzag(token.int_value()));
+        } else if (flags & kFloatValue) {
+            double value = token.float_value();
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            putFixed64(body, bits);
+        }
+    }
+
+    std::string header(kMagic, sizeof(kMagic));
+    putFixed64(header, sourceHash);
+    putFixed64(header, macroFingerprint);
+    putFixed64(header, source.size());
+    putVarint(header, kLexerVersion);
+    putVarint(header, kTokenTypeCount);
+    putVarint(header, tokens.size());
+    putVarint(header, inlineText.size());
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+
+    // Write to a temporary name and rename, so readers never see half an entry
+    std::string path = entryPath(sourceHash, macroFingerprint);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(header.data(), header.size());
+        out.write(inlineText.data(), inlineText.size());
+        out.write(body.data(), body.size());
+        if (!out) return false;
+    }
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+bool TokenCache::load(std::string_view source, uint64_t macroFingerprint, std::vector<Token>& tokens) {
+    uint64_t sourceHash = hash(source);
+    SourceBuffer entry;
+    if (!entry.open(entryPath(sourceHash, macroFingerprint))) return false;
+
+    std::string_view data = entry.view();
+    if (data.size() < sizeof(kMagic) || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    Reader in{data.data() + sizeof(kMagic), data.data() + data.size()};
+    if (in.fixed64() != sourceHash || in.fixed64() != macroFingerprint ||
+        in.fixed64() != source.size() || in.varint() != kLexerVersion ||
+        in.varint() != kTokenTypeCount) {
+        return false;
+    }
+    uint64_t count = in.varint();
+    uint64_t inlineSize = in.varint();
+    if (!in.ok || inlineSize > static_cast<uint64_t>(in.end - in.p) || count > data.size()) {
+        return false;
+    }
+    const char* inlineText = in.p;
+    in.p += inlineSize;
+
+    std::vector<Token> decoded;
+    decoded.reserve(count);
+    uint64_t offset = 0;
+    for (uint64_t i = 0; i < count && in.ok; ++i) {
+        uint64_t head = in.varint();
+        uint64_t type = head >> kFlagBits;
+        uint64_t flags = head & ((1u << kFlagBits) - 1);
+        offset += in.varint();
+        uint64_t where = (flags & kTextAtOffset) ? 0 : in.varint();
+        uint64_t length = in.varint();
+        if (!in.ok || type >= kTokenTypeCount || offset > source.size()) {
+            return false;
+        }
+
+        const char* text;
+        if (flags & kTextInSource) {
+            int64_t start = static_cast<int64_t>(offset) + unzigzag(where);
+            if (start < 0 || static_cast<uint64_t>(start) + length > source.size()) return false;
+            text = source.data() + start;
+        } else {
+            if (where + length > inlineSize) return false;
+            text = inlineText + where;
+        }
+
+        Token token(static_cast<TokenType>(type), std::string_view(text, length),
+                    static_cast<uint32_t>(offset));
+        token.set_has_escape((flags & kHasEscape) != 0);
+        if (token.type() == TokenType::IDENTIFIER) {
+            token.set_symbol(intern(token.view()));   // IDs are per process, so they are not stored
+        }
+        if (flags & kIntValue) {
+            token.set_int_value(unzigzag(in.varint()));
+        } else if (flags & kFloatValue) {
+            uint64_t bits = in.fixed64();
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            token.set_float_value(value);
+        }
+        decoded.push_back(token);
+    }
+    if (!in.ok || decoded.size() != count) return false;
+
+    mappings_.push_back(std::move(entry));
+    tokens = std::move(decoded);
+    return true;
+}
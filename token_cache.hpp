@@ -0,0 +1,42 @@
+#ifndef TOKEN_CACHE_HPP
+#define TOKEN_CACHE_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\tokens.hpp"
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\source_buffer.hpp"
+
+// On-disk cache of lexed token streams.
+//
+// Entries are keyed by a hash of the source text plus a fingerprint of the
+// macros defined before lexing started, one file per key in the cache
+// directory. Each entry is a compact binary stream: per token the type,
+// offset delta, text location and decoded literal value, all varint-encoded.
+// Token text that lives in the source is stored as a position; anything
+// else (directive text, error messages) is stored inline and, after a hit,
+// viewed straight out of the memory-mapped entry. The cache keeps those
+// mappings alive, so it must outlive the tokens it returns. Entries written
+// by a lexer with a different output version are misses.
+class TokenCache {
+public:
+    explicit TokenCache(std::string directory);
+
+    // Fill tokens from the cache; false on a miss or an unreadable entry.
+    // On success the tokens view into source, which must outlive them.
+    bool load(std::string_view source, uint64_t macroFingerprint, std::vector<Token>& tokens);
+
+    // Write the entry for source. Returns false if it could not be written.
+    bool store(std::string_view source, uint64_t macroFingerprint, const std::vector<Token>& tokens) const;
+
+    static uint64_t hash(std::string_view data);   // FNV-1a, 64-bit
+
+private:
+    std::string directory_;
+    std::vector<SourceBuffer> mappings_;   // Entries loaded so far (back inline token text)
+
+    std::string entryPath(uint64_t sourceHash, uint64_t macroFingerprint) const;
+};
+
+#endif // TOKEN_CACHE_HPP
@@ -0,0 +1,186 @@
+#ifndef TOKEN_NAMES_HPP
+#define TOKEN_NAMES_HPP
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\tokens.hpp"
+
+// Printable name of every TokenType, as used by the token dump. The list
+// mirrors the enum; the lookup array below is filled from it at compile
+// time, and a missing or repeated entry fails the build.
+struct TokenNameEntry {
+    TokenType type;
+    std::string_view name;
+};
+
+inline constexpr TokenNameEntry kTokenNames[] = {
+    {TokenType::END_OF_FILE, "END_OF_FILE"}, {TokenType::ERROR, "ERROR"},
+    {TokenType::IDENTIFIER, "IDENTIFIER"}, {TokenType::INTEGER, "INTEGER"},
+    {TokenType::FLOAT, "FLOAT"}, {TokenType::STRING, "STRING"}, {TokenType::CHARACTER, "CHARACTER"},
+
+    // C++ keywords
+    {TokenType::INT, "INT"}, {TokenType::VOID, "VOID"}, {TokenType::CHAR, "CHAR"},
+    {TokenType::FLOAT_TYPE, "FLOAT_TYPE"}, {TokenType::DOUBLE, "DOUBLE"}, {TokenType::BOOL, "BOOL"},
+    {TokenType::CLASS, "CLASS"}, {TokenType::STRUCT, "STRUCT"}, {TokenType::ENUM, "ENUM"},
+    {TokenType::UNION, "UNION"}, {TokenType::CONST, "CONST"}, {TokenType::UNSIGNED, "UNSIGNED"},
+    {TokenType::SIGNED, "SIGNED"}, {TokenType::SHORT, "SHORT"}, {TokenType::LONG, "LONG"},
+    {TokenType::STATIC, "STATIC"}, {TokenType::EXTERN, "EXTERN"}, {TokenType::REGISTER, "REGISTER"},
+    {TokenType::INLINE, "INLINE"}, {TokenType::VIRTUAL, "VIRTUAL"},
+    {TokenType::EXPLICIT, "EXPLICIT"}, {TokenType::FRIEND, "FRIEND"},
+    {TokenType::PRIVATE, "PRIVATE"}, {TokenType::PUBLIC, "PUBLIC"},
+    {TokenType::PROTECTED, "PROTECTED"}, {TokenType::IF, "IF"}, {TokenType::ELSE, "ELSE"},
+    {TokenType::FOR, "FOR"}, {TokenType::WHILE, "WHILE"}, {TokenType::DO, "DO"},
+    {TokenType::SWITCH, "SWITCH"}, {TokenType::CASE, "CASE"}, {TokenType::DEFAULT, "DEFAULT"},
+    {TokenType::BREAK, "BREAK"}, {TokenType::CONTINUE, "CONTINUE"}, {TokenType::RETURN, "RETURN"},
+    {TokenType::GOTO, "GOTO"}, {TokenType::NEWLINE, "NEWLINE"},
+
+    // Operators & punctuation
+    {TokenType::PLUS, "PLUS"}, {TokenType::MINUS, "MINUS"}, {TokenType::STAR, "STAR"},
+    {TokenType::SLASH, "SLASH"}, {TokenType::PERCENT, "PERCENT"},
+    {TokenType::AMPERSAND, "AMPERSAND"}, {TokenType::PIPE, "PIPE"}, {TokenType::CARET, "CARET"},
+    {TokenType::TILDE, "TILDE"}, {TokenType::EXCLAIM, "EXCLAIM"}, {TokenType::EQUAL, "EQUAL"},
+    {TokenType::LESS, "LESS"}, {TokenType::GREATER, "GREATER"}, {TokenType::INCREMENT, "INCREMENT"},
+    {TokenType::DECREMENT, "DECREMENT"}, {TokenType::PLUS_EQUAL, "PLUS_EQUAL"},
+    {TokenType::MINUS_EQUAL, "MINUS_EQUAL"}, {TokenType::STAR_EQUAL, "STAR_EQUAL"},
+    {TokenType::SLASH_EQUAL, "SLASH_EQUAL"}, {TokenType::PERCENT_EQUAL, "PERCENT_EQUAL"},
+    {TokenType::AND_EQUAL, "AND_EQUAL"}, {TokenType::OR_EQUAL, "OR_EQUAL"},
+    {TokenType::XOR_EQUAL, "XOR_EQUAL"}, {TokenType::LESS_LESS, "LESS_LESS"},
+    {TokenType::GREATER_GREATER, "GREATER_GREATER"},
+    {TokenType::LEFT_SHIFT_EQUAL, "LEFT_SHIFT_EQUAL"},
+    {TokenType::RIGHT_SHIFT_EQUAL, "RIGHT_SHIFT_EQUAL"}, {TokenType::EQUAL_EQUAL, "EQUAL_EQUAL"},
+    {TokenType::NOT_EQUAL, "NOT_EQUAL"}, {TokenType::LESS_EQUAL, "LESS_EQUAL"},
+    {TokenType::GREATER_EQUAL, "GREATER_EQUAL"}, {TokenType::AND_AND, "AND_AND"},
+    {TokenType::OR_OR, "OR_OR"}, {TokenType::QUESTION, "QUESTION"}, {TokenType::ARROW, "ARROW"},
+    {TokenType::ARROW_STAR, "ARROW_STAR"}, {TokenType::DOT_STAR, "DOT_STAR"},
+    {TokenType::ELLIPSIS, "ELLIPSIS"}, {TokenType::SPACESHIP, "SPACESHIP"},
+    {TokenType::LEFT_PAREN, "LEFT_PAREN"}, {TokenType::RIGHT_PAREN, "RIGHT_PAREN"},
+    {TokenType::LEFT_BRACE, "LEFT_BRACE"}, {TokenType::RIGHT_BRACE, "RIGHT_BRACE"},
+    {TokenType::LEFT_BRACKET, "LEFT_BRACKET"}, {TokenType::RIGHT_BRACKET, "RIGHT_BRACKET"},
+    {TokenType::SEMICOLON, "SEMICOLON"}, {TokenType::COMMA, "COMMA"}, {TokenType::DOT, "DOT"},
+    {TokenType::COLON, "COLON"}, {TokenType::SCOPE, "SCOPE"}, {TokenType::HASH, "HASH"},
+    {TokenType::STRING_LITERAL, "STRING_LITERAL"}, {TokenType::CHAR_LITERAL, "CHAR_LITERAL"},
+
+    // STL Containers
+    {TokenType::VECTOR, "VECTOR"}, {TokenType::MAP, "MAP"}, {TokenType::SET, "SET"},
+    {TokenType::LIST, "LIST"}, {TokenType::DEQUE, "DEQUE"},
+    {TokenType::UNORDERED_MAP, "UNORDERED_MAP"}, {TokenType::UNORDERED_SET, "UNORDERED_SET"},
+    {TokenType::MULTIMAP, "MULTIMAP"}, {TokenType::MULTISET, "MULTISET"},
+    {TokenType::STACK, "STACK"}, {TokenType::QUEUE, "QUEUE"},
+    {TokenType::PRIORITY_QUEUE, "PRIORITY_QUEUE"}, {TokenType::BITSET, "BITSET"},
+    {TokenType::ARRAY, "ARRAY"}, {TokenType::FORWARD_LIST, "FORWARD_LIST"},
+    {TokenType::PAIR, "PAIR"}, {TokenType::TUPLE, "TUPLE"}, {TokenType::STRING_LIB, "STRING_LIB"},
+    {TokenType::OPTIONAL, "OPTIONAL"}, {TokenType::VARIANT, "VARIANT"}, {TokenType::ANY, "ANY"},
+    {TokenType::SPAN, "SPAN"}, {TokenType::VALARRAY, "VALARRAY"},
+
+    // C standard lib functions
+    {TokenType::PRINTF, "PRINTF"}, {TokenType::SCANF, "SCANF"}, {TokenType::MALLOC, "MALLOC"},
+    {TokenType::FREE, "FREE"}, {TokenType::MEMCPY, "MEMCPY"}, {TokenType::STRCPY, "STRCPY"},
+    {TokenType::STRLEN, "STRLEN"},
+
+    // C++ I/O Streams
+    {TokenType::CIN, "CIN"}, {TokenType::COUT, "COUT"}, {TokenType::CERR, "CERR"},
+    {TokenType::CLIN, "CLIN"}, {TokenType::GETLINE, "GETLINE"}, {TokenType::PUT, "PUT"},
+    {TokenType::GET, "GET"}, {TokenType::FLUSH, "FLUSH"}, {TokenType::OPEN, "OPEN"},
+    {TokenType::CLOSE, "CLOSE"}, {TokenType::READ, "READ"}, {TokenType::WRITE, "WRITE"},
+
+    // Algorithms
+    {TokenType::SORT, "SORT"}, {TokenType::FIND, "FIND"}, {TokenType::COUNT, "COUNT"},
+    {TokenType::COPY, "COPY"}, {TokenType::REVERSE, "REVERSE"},
+    {TokenType::ACCUMULATE, "ACCUMULATE"}, {TokenType::ALL_OF, "ALL_OF"},
+    {TokenType::ANY_OF, "ANY_OF"}, {TokenType::NONE_OF, "NONE_OF"},
+    {TokenType::LOWER_BOUND, "LOWER_BOUND"}, {TokenType::UPPER_BOUND, "UPPER_BOUND"},
+
+    // Math
+    {TokenType::ABS, "ABS"}, {TokenType::FABS, "FABS"}, {TokenType::POW, "POW"},
+    {TokenType::SQRT, "SQRT"}, {TokenType::SIN, "SIN"}, {TokenType::COS, "COS"},
+    {TokenType::TAN, "TAN"}, {TokenType::FLOOR, "FLOOR"}, {TokenType::CEIL, "CEIL"},
+    {TokenType::ROUND, "ROUND"}, {TokenType::RAND, "RAND"}, {TokenType::SRAND, "SRAND"},
+    {TokenType::EXIT, "EXIT"},
+
+    // Strings
+    {TokenType::STOI, "STOI"}, {TokenType::STOF, "STOF"}, {TokenType::STOD, "STOD"},
+    {TokenType::TO_STRING, "TO_STRING"}, {TokenType::STRCMP, "STRCMP"},
+    {TokenType::STRNCMP, "STRNCMP"}, {TokenType::STRCHR, "STRCHR"}, {TokenType::STRRCHR, "STRRCHR"},
+    {TokenType::STRSTR, "STRSTR"}, {TokenType::STRCAT, "STRCAT"}, {TokenType::STRNCAT, "STRNCAT"},
+
+    // Memory and allocation
+    {TokenType::NEW, "NEW"}, {TokenType::DELETE, "DELETE"}, {TokenType::ALLOCATE, "ALLOCATE"},
+    {TokenType::DEALLOCATE, "DEALLOCATE"},
+
+    // Time
+    {TokenType::TIME, "TIME"}, {TokenType::CLOCK, "CLOCK"}, {TokenType::DIFFTIME, "DIFFTIME"},
+    {TokenType::STRFTIME, "STRFTIME"}, {TokenType::LOCALTIME, "LOCALTIME"},
+    {TokenType::GMTIME, "GMTIME"},
+
+    // Concurrency
+    {TokenType::THREAD, "THREAD"}, {TokenType::MUTEX, "MUTEX"},
+    {TokenType::LOCK_GUARD, "LOCK_GUARD"}, {TokenType::UNIQUE_LOCK, "UNIQUE_LOCK"},
+    {TokenType::ASYNC, "ASYNC"}, {TokenType::FUTURE, "FUTURE"}, {TokenType::PROMISE, "PROMISE"},
+
+    // Exceptions
+    {TokenType::TRY, "TRY"}, {TokenType::CATCH, "CATCH"}, {TokenType::THROW, "THROW"},
+    {TokenType::EXCEPTION, "EXCEPTION"}, {TokenType::LOGIC_ERROR, "LOGIC_ERROR"},
+    {TokenType::RUNTIME_ERROR, "RUNTIME_ERROR"},
+
+    // RTTI / Casting
+    {TokenType::TYPEID, "TYPEID"}, {TokenType::STATIC_CAST, "STATIC_CAST"},
+    {TokenType::DYNAMIC_CAST, "DYNAMIC_CAST"}, {TokenType::CONST_CAST, "CONST_CAST"},
+    {TokenType::REINTERPRET_CAST, "REINTERPRET_CAST"}, {TokenType::TEMPLATE, "TEMPLATE"},
+
+    // Namespace and template tokens
+    {TokenType::TYPEDEF, "TYPEDEF"}, {TokenType::USING, "USING"},
+    {TokenType::NAMESPACE, "NAMESPACE"}, {TokenType::TEMPLATE_LESS, "TEMPLATE_LESS"},
+    {TokenType::TEMPLATE_GREATER, "TEMPLATE_GREATER"},
+    {TokenType::TEMPLATE_COMMA, "TEMPLATE_COMMA"},
+
+    // Preprocessor directives
+    {TokenType::PREPROCESSOR_INCLUDE, "PREPROCESSOR_INCLUDE"},
+    {TokenType::PREPROCESSOR_DEFINE, "PREPROCESSOR_DEFINE"},
+    {TokenType::PREPROCESSOR_IFDEF, "PREPROCESSOR_IFDEF"},
+    {TokenType::PREPROCESSOR_IFNDEF, "PREPROCESSOR_IFNDEF"},
+    {TokenType::PREPROCESSOR_IF, "PREPROCESSOR_IF"},
+    {TokenType::PREPROCESSOR_ELIF, "PREPROCESSOR_ELIF"},
+    {TokenType::PREPROCESSOR_ELSE, "PREPROCESSOR_ELSE"},
+    {TokenType::PREPROCESSOR_ENDIF, "PREPROCESSOR_ENDIF"},
+    {TokenType::PREPROCESSOR_UNDEF, "PREPROCESSOR_UNDEF"},
+    {TokenType::PREPROCESSOR_PRAGMA, "PREPROCESSOR_PRAGMA"},
+    {TokenType::PREPROCESSOR_UNKNOWN, "PREPROCESSOR_UNKNOWN"}
+};
+
+inline constexpr size_t kTokenTypeCount = static_cast<size_t>(TokenType::PREPROCESSOR_UNKNOWN) + 1;
+
+namespace token_name_detail {
+
+constexpr std::array<std::string_view, kTokenTypeCount> buildNameTable() {
+    std::array<std::string_view, kTokenTypeCount> table{};
+    for (const TokenNameEntry& entry : kTokenNames) {
+        table[static_cast<size_t>(entry.type)] = entry.name;
+    }
+    return table;
+}
+
+inline constexpr std::array<std::string_view, kTokenTypeCount> kTable = buildNameTable();
+
+constexpr bool everyTypeNamedOnce() {
+    if (sizeof(kTokenNames) / sizeof(kTokenNames[0]) != kTokenTypeCount) return false;
+    for (std::string_view name : kTable) {
+        if (name.empty()) return false;
+    }
+    return true;
+}
+
+static_assert(everyTypeNamedOnce(), "kTokenNames must name every TokenType exactly once");
+
+} // namespace token_name_detail
+
+// Name of a TokenType ("UNKNOWN" for a value outside the enum)
+constexpr std::string_view tokenTypeName(TokenType type) {
+    size_t index = static_cast<size_t>(type);
+    return index < kTokenTypeCount ? token_name_detail::kTable[index] : std::string_view("UNKNOWN");
+}
+
+static_assert(tokenTypeName(TokenType::IDENTIFIER) == "IDENTIFIER", "token name table out of sync");
+static_assert(tokenTypeName(TokenType::PREPROCESSOR_UNKNOWN) == "PREPROCESSOR_UNKNOWN", "token name table out of sync");
+
+#endif // TOKEN_NAMES_HPP
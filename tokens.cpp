@@ -1,158 +1,93 @@
 #include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\tokens.hpp"
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\token_names.hpp"
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\char_class.hpp"
 #include <sstream>
 #include <iomanip>
-#include <unordered_map>
 
 namespace {
 
-static const std::unordered_map<TokenType, const char*> token_type_names = {
-    {TokenType::END_OF_FILE, "END_OF_FILE"}, {TokenType::ERROR, "ERROR"},
-    {TokenType::IDENTIFIER, "IDENTIFIER"}, {TokenType::INTEGER, "INTEGER"},
-    {TokenType::FLOAT, "FLOAT"}, {TokenType::STRING, "STRING"},
-    {TokenType::CHARACTER, "CHARACTER"}, {TokenType::INT, "INT"},
-    {TokenType::VOID, "VOID"}, {TokenType::CHAR, "CHAR"},
-    {TokenType::FLOAT_TYPE, "FLOAT_TYPE"}, {TokenType::DOUBLE, "DOUBLE"},
-    {TokenType::BOOL, "BOOL"}, {TokenType::CLASS, "CLASS"},
-    {TokenType::STRUCT, "STRUCT"}, {TokenType::ENUM, "ENUM"},
-    {TokenType::UNION, "UNION"}, {TokenType::CONST, "CONST"},
-    {TokenType::UNSIGNED, "UNSIGNED"}, {TokenType::SIGNED, "SIGNED"},
-    {TokenType::SHORT, "SHORT"}, {TokenType::LONG, "LONG"},
-    {TokenType::STATIC, "STATIC"}, {TokenType::EXTERN, "EXTERN"},
-    {TokenType::REGISTER, "REGISTER"}, {TokenType::INLINE, "INLINE"},
-    {TokenType::VIRTUAL, "VIRTUAL"}, {TokenType::EXPLICIT, "EXPLICIT"},
-    {TokenType::FRIEND, "FRIEND"}, {TokenType::PRIVATE, "PRIVATE"},
-    {TokenType::PUBLIC, "PUBLIC"}, {TokenType::PROTECTED, "PROTECTED"},
-    {TokenType::IF, "IF"}, {TokenType::ELSE, "ELSE"},
-    {TokenType::FOR, "FOR"}, {TokenType::WHILE, "WHILE"},
-    {TokenType::DO, "DO"}, {TokenType::SWITCH, "SWITCH"},
-    {TokenType::CASE, "CASE"}, {TokenType::DEFAULT, "DEFAULT"},
-    {TokenType::BREAK, "BREAK"}, {TokenType::CONTINUE, "CONTINUE"},
-    {TokenType::RETURN, "RETURN"}, {TokenType::GOTO, "GOTO"},
-    {TokenType::NEWLINE, "NEWLINE"}, 
-
-    {TokenType::PLUS, "PLUS"}, {TokenType::MINUS, "MINUS"},
-    {TokenType::STAR, "STAR"}, {TokenType::SLASH, "SLASH"},
-    {TokenType::PERCENT, "PERCENT"}, {TokenType::AMPERSAND, "AMPERSAND"},
-    {TokenType::PIPE, "PIPE"}, {TokenType::CARET, "CARET"},
-    {TokenType::TILDE, "TILDE"}, {TokenType::EXCLAIM, "EXCLAIM"},
-    {TokenType::EQUAL, "EQUAL"}, {TokenType::LESS, "LESS"},
-    {TokenType::GREATER, "GREATER"}, {TokenType::PLUS_EQUAL, "PLUS_EQUAL"},
-    {TokenType::MINUS_EQUAL, "MINUS_EQUAL"}, {TokenType::STAR_EQUAL, "STAR_EQUAL"},
-    {TokenType::SLASH_EQUAL, "SLASH_EQUAL"}, {TokenType::PERCENT_EQUAL, "PERCENT_EQUAL"},
-    {TokenType::AND_EQUAL, "AND_EQUAL"}, {TokenType::OR_EQUAL, "OR_EQUAL"},
-    {TokenType::XOR_EQUAL, "XOR_EQUAL"}, {TokenType::LESS_LESS, "LESS_LESS"},
-    {TokenType::GREATER_GREATER, "GREATER_GREATER"},
-
-    // New multi-char assignment operators
-    {TokenType::LEFT_SHIFT_EQUAL, "LEFT_SHIFT_EQUAL"},
-    {TokenType::RIGHT_SHIFT_EQUAL, "RIGHT_SHIFT_EQUAL"},
-
-    {TokenType::EQUAL_EQUAL, "EQUAL_EQUAL"},
-    {TokenType::NOT_EQUAL, "NOT_EQUAL"},
-    {TokenType::LESS_EQUAL, "LESS_EQUAL"},
-    {TokenType::GREATER_EQUAL, "GREATER_EQUAL"},
-    {TokenType::AND_AND, "AND_AND"},
-    {TokenType::OR_OR, "OR_OR"},
-    {TokenType::DECREMENT, "DECREMENT"},
-    {TokenType::ARROW, "ARROW"},
-    {TokenType::INCREMENT, "INCREMENT"},
-   
-
-    {TokenType::LEFT_PAREN, "LEFT_PAREN"},
-    {TokenType::RIGHT_PAREN, "RIGHT_PAREN"},
-    {TokenType::LEFT_BRACE, "LEFT_BRACE"},
-    {TokenType::RIGHT_BRACE, "RIGHT_BRACE"},
-    {TokenType::LEFT_BRACKET, "LEFT_BRACKET"},
-    {TokenType::RIGHT_BRACKET, "RIGHT_BRACKET"},
-    {TokenType::SEMICOLON, "SEMICOLON"},
-    {TokenType::COMMA, "COMMA"},
-    {TokenType::DOT, "DOT"},
-    {TokenType::COLON, "COLON"},
-    {TokenType::SCOPE, "SCOPE"},
-    {TokenType::HASH, "HASH"},
-    {TokenType::QUESTION, "QUESTION"},
-
-    // {TokenType::STRING_LITERAL, "STRING_LITERAL"},
-    // {TokenType::CHAR_LITERAL, "CHAR_LITERAL"},
-
-    // STL Containers
-    {TokenType::VECTOR, "VECTOR"},
-    {TokenType::MAP, "MAP"},
-    {TokenType::SET, "SET"},
-    {TokenType::LIST, "LIST"},
-    {TokenType::DEQUE, "DEQUE"},
-    {TokenType::UNORDERED_MAP, "UNORDERED_MAP"},
-    {TokenType::UNORDERED_SET, "UNORDERED_SET"},
-    {TokenType::STRING_LIB, "STRING_LIB"},
-    {TokenType::MULTIMAP, "MULTIMAP"},
-    {TokenType::MULTISET, "MULTISET"},
-    {TokenType::STACK, "STACK"},
-    {TokenType::QUEUE, "QUEUE"},
-    {TokenType::PRIORITY_QUEUE, "PRIORITY_QUEUE"},
-    {TokenType::BITSET, "BITSET"},
-    {TokenType::ARRAY, "ARRAY"},
-    {TokenType::FORWARD_LIST, "FORWARD_LIST"},
-    {TokenType::PAIR, "PAIR"},
-    {TokenType::TUPLE, "TUPLE"},
-    {TokenType::OPTIONAL, "OPTIONAL"},
-    {TokenType::VARIANT, "VARIANT"},
-    {TokenType::ANY, "ANY"},
-    {TokenType::SPAN, "SPAN"},
-    {TokenType::VALARRAY, "VALARRAY"},
-
-
-    // C standard lib functions
-    {TokenType::PRINTF, "PRINTF"},
-    {TokenType::SCANF, "SCANF"},
-    {TokenType::MALLOC, "MALLOC"},
-    {TokenType::FREE, "FREE"},
-    {TokenType::MEMCPY, "MEMCPY"},
-    {TokenType::STRCPY, "STRCPY"},
-    {TokenType::STRLEN, "STRLEN"},
-
-    // Template and Namespace tokens
-    {TokenType::TEMPLATE, "TEMPLATE"},
-    {TokenType::NAMESPACE, "NAMESPACE"},
-    {TokenType::USING, "USING"},
-    {TokenType::TYPEDEF, "TYPEDEF"},
-    {TokenType::TEMPLATE_LESS, "TEMPLATE_LESS"},
-    {TokenType::TEMPLATE_GREATER, "TEMPLATE_GREATER"},
-    {TokenType::TEMPLATE_COMMA, "TEMPLATE_COMMA"},
+std::string formatToken(const Token& token, const LineIndex* lines) {
+    std::ostringstream oss;
+    oss << "Token(type=" << tokenTypeName(token.type())
+        << ", text='" << token.view() << "'";
+    if (lines) {
+        oss << ", line=" << lines->lineOf(token.offset())
+            << ", column=" << lines->columnOf(token.offset());
+    } else {
+        oss << ", offset=" << token.offset();
+    }
 
-    // Preprocessor directives
-    {TokenType::PREPROCESSOR_INCLUDE, "PREPROCESSOR_INCLUDE"},
-    {TokenType::PREPROCESSOR_DEFINE, "PREPROCESSOR_DEFINE"},
-    {TokenType::PREPROCESSOR_UNDEF, "PREPROCESSOR_UNDEF"},
-    {TokenType::PREPROCESSOR_PRAGMA, "PREPROCESSOR_PRAGMA"},
-    {TokenType::PREPROCESSOR_UNKNOWN, "PREPROCESSOR_UNKNOWN"},
-    {TokenType::PREPROCESSOR_IFDEF, "PREPROCESSOR_IFDEF"},
-    {TokenType::PREPROCESSOR_IFNDEF, "PREPROCESSOR_IFNDEF"},
-    {TokenType::PREPROCESSOR_IF, "PREPROCESSOR_IF"},
-    {TokenType::PREPROCESSOR_ELIF, "PREPROCESSOR_ELIF"},
-    {TokenType::PREPROCESSOR_ELSE, "PREPROCESSOR_ELSE"},
-    {TokenType::PREPROCESSOR_ENDIF, "PREPROCESSOR_ENDIF"}
-};
+    if (token.type() == TokenType::INTEGER) {
+        oss << ", int_value=" << token.int_value();
+    } else if (token.type() == TokenType::FLOAT) {
+        oss << ", float_value=" << std::fixed << std::setprecision(6) << token.float_value();
+    }
 
-const char* getTokenTypeName(TokenType type) {
-    auto it = token_type_names.find(type);
-    return it != token_type_names.end() ? it->second : "UNKNOWN";
+    oss << ")";
+    return oss.str();
 }
 
 } // unnamed namespace
 
+Token::Token()
+    : text_(""), int_value_(0), length_(0), offset_(0), symbol_(), file_(0),
+      type_(static_cast<uint8_t>(TokenType::END_OF_FILE)), is_float_(false), has_escape_(false),
+      no_expand_(false) {}
+
 std::string Token::toString() const {
-    std::ostringstream oss;
-    oss << "Token(type=" << getTokenTypeName(type())
-        << ", text='" << text() << "'"
-        << ", line=" << line()
-        << ", column=" << column();
+    return formatToken(*this, nullptr);
+}
 
-    if (type() == TokenType::INTEGER) {
-        oss << ", int_value=" << int_value();
-    } else if (type() == TokenType::FLOAT) {
-        oss << ", float_value=" << std::fixed << std::setprecision(6) << float_value();
-    }
+std::string Token::toString(const LineIndex& lines) const {
+    return formatToken(*this, &lines);
+}
 
-    oss << ")";
-    return oss.str();
+std::string decodeEscapes(std::string_view raw) {
+    std::string out;
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        char c = raw[i];
+        if (c != '\\' || i + 1 == raw.size()) {
+            out += c;
+            continue;
+        }
+
+        char e = raw[++i];
+        switch (e) {
+        case 'n': out += '\n'; break;
+        case 't': out += '\t'; break;
+        case 'r': out += '\r'; break;
+        case 'a': out += '\a'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'v': out += '\v'; break;
+        case '\n': break;   // Line continuation
+        case '\r':
+            if (i + 1 < raw.size() && raw[i + 1] == '\n') ++i;   // Line continuation in a CRLF source
+            else out += e;
+            break;
+        case 'x': {
+            unsigned value = 0;   // Kept to the low 8 bits, like a char, as digits arrive
+            while (i + 1 < raw.size() && charclass::isHexDigit(raw[i + 1])) {
+                value = ((value << 4) | charclass::digitValue(raw[++i])) & 0xFF;
+            }
+            out += static_cast<char>(value);
+            break;
+        }
+        default:
+            if (e >= '0' && e <= '7') {
+                int value = e - '0';
+                for (int digits = 1; digits < 3 && i + 1 < raw.size() &&
+                                     raw[i + 1] >= '0' && raw[i + 1] <= '7'; ++digits) {
+                    value = (value << 3) | (raw[++i] - '0');
+                }
+                out += static_cast<char>(value);
+            }
+            else {
+                out += e;   // \\, \', \", \? and unknown escapes map to themselves
+            }
+            break;
+        }
+    }
+    return out;
 }
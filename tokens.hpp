@@ -2,7 +2,12 @@
 #define TOKEN_HPP
 
 #include <string>
+#include <string_view>
 #include <memory>
+#include <cstdint>
+#include <type_traits>
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\line_index.hpp"
+#include "D:\\vs code\\PROJECT\\PBL_TRANSPILER\\ver4\\symbol.hpp"
 
 enum class TokenType {
     END_OF_FILE, ERROR,
@@ -40,6 +45,10 @@ enum class TokenType {
 
 
     ARROW,              // ->
+    ARROW_STAR,         // ->*
+    DOT_STAR,           // .*
+    ELLIPSIS,           // ...
+    SPACESHIP,          // <=>
 
     LEFT_PAREN, RIGHT_PAREN,
     LEFT_BRACE, RIGHT_BRACE,
@@ -137,40 +146,76 @@ enum class TokenType {
 };
 
 
+// Tokens are small trivially-copyable values. The text is a view into the
+// lexer's source buffer (or into storage owned by the Lexer for synthesized
+// text), so a Token must not outlive the source or the Lexer that made it.
+// Positions are stored as a byte offset into the file the token came from
+// (file 0 is the lexer's own source, others are #included); resolve them
+// through that file's LineIndex. Identifiers also carry their interned Symbol.
 class Token {
 public:
     
     Token();
-    Token(TokenType type, std::string text, int line, int column)
-        : type_(type), text_(std::move(text)), line_(line), column_(column),
-          int_value_(0), is_float_(false), has_escape_(false) {}
-
-    TokenType type() const { return type_; }
-    const std::string& text() const { return text_; }
-    int line() const { return line_; }
-    int column() const { return column_; }
+    Token(TokenType type, std::string_view text, uint32_t offset)
+        : text_(text.data()), int_value_(0), length_(static_cast<uint32_t>(text.size())),
+          offset_(offset), symbol_(), file_(0), type_(static_cast<uint8_t>(type)),
+          is_float_(false), has_escape_(false), no_expand_(false) {}
+
+    TokenType type() const { return static_cast<TokenType>(type_); }
+    std::string_view view() const { return std::string_view(text_, length_); }
+    std::string text() const { return std::string(text_, length_); }   // Materializes a copy
+    uint32_t offset() const { return offset_; }   // Byte offset of the token in its file
+    uint16_t file() const { return file_; }       // 0 = the lexer's source, else an IncludeResolver file id
+    Symbol symbol() const { return symbol_; }     // Interned spelling (identifiers only)
     long long int_value() const { return int_value_; }
     double float_value() const { return float_value_; }
     bool is_float() const { return is_float_; }
     bool has_escape() const { return has_escape_; }
+    bool no_expand() const { return no_expand_; }   // Macro name met inside its own expansion
 
     void set_int_value(long long value) { int_value_ = value; is_float_ = false; }
     void set_float_value(double value) { float_value_ = value; is_float_ = true; }
-
-    std::string toString() const;
+    void set_has_escape(bool value) { has_escape_ = value; }
+    void set_no_expand(bool value) { no_expand_ = value; }
+    void set_symbol(Symbol symbol) { symbol_ = symbol; }
+    void set_file(uint16_t file) { file_ = file; }
+
+    // Same token with its text and offset moved (used when splicing token lists)
+    Token relocated(const char* text, uint32_t offset) const {
+        Token token = *this;
+        token.text_ = text;
+        token.offset_ = offset;
+        return token;
+    }
+
+    std::string toString() const;                         // Position printed as a byte offset
+    std::string toString(const LineIndex& lines) const;   // Position printed as line/column
 
 private:
-    TokenType type_;
-    std::string text_;
-    int line_;
-    int column_;
+    // Widest fields first so the whole token packs into 32 bytes
+    const char* text_;
     union {
         long long int_value_;
         double float_value_;
     };
-    bool is_float_;
-    bool has_escape_;
+    uint32_t length_;
+    uint32_t offset_;
+    Symbol symbol_;
+    uint16_t file_;
+    uint8_t type_;       // TokenType, narrowed
+    bool is_float_ : 1;
+    bool has_escape_ : 1;
+    bool no_expand_ : 1;   // Never macro-expanded again, even outside that expansion
 };
 
+// Decode the C++ escape sequences in the body of a string or char literal
+// (quotes already stripped). Only needed when Token::has_escape() is set;
+// otherwise the raw text is already the value.
+std::string decodeEscapes(std::string_view raw);
+
+static_assert(std::is_trivially_copyable<Token>::value, "Token must stay trivially copyable");
+static_assert(sizeof(Token) <= 32, "Token must stay within 32 bytes");
+static_assert(static_cast<int>(TokenType::PREPROCESSOR_UNKNOWN) <= UINT8_MAX, "TokenType must fit Token::type_");
+
 #endif
 